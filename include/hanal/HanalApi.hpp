@@ -11,6 +11,7 @@
 //////////////
 // includes //
 //////////////
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -45,6 +46,48 @@ class HanalApi {
    * @return          tagged result. JSON format
    */
   virtual const std::string& pos_tag(const char* sent, const char* opt_str) = 0;
+
+  /**
+   * @brief           part-of-speech tagging for UTF-8 text with length (not necessarily null terminated)
+   * @param  sent     input sentence
+   * @param  len      length of sentence in bytes
+   * @param  opt_str  option string
+   * @return          tagged result. JSON format
+   */
+  virtual const std::string& pos_tag(const char* sent, size_t len, const char* opt_str) = 0;
+
+  /**
+   * @brief           part-of-speech tagging for UTF-16 text. offsets are in UTF-16 code units
+   * @param  sent     input sentence
+   * @param  opt_str  option string
+   * @return          tagged result. JSON format
+   */
+  virtual const std::string& pos_tag(const char16_t* sent, const char* opt_str) = 0;
+
+  /**
+   * @brief           part-of-speech tagging for UTF-32 text. offsets are in code points
+   * @param  sent     input sentence
+   * @param  opt_str  option string
+   * @return          tagged result. JSON format
+   */
+  virtual const std::string& pos_tag(const char32_t* sent, const char* opt_str) = 0;
+
+  /**
+   * @brief           split document into sentences and part-of-speech tagging for each sentence
+   * @param  doc      input document
+   * @param  opt_str  option string
+   * @return          tagged result. JSON format
+   */
+  virtual const std::string& pos_tag_doc(const char* doc, const char* opt_str) = 0;
+
+  /**
+   * @brief           split document with length (not necessarily null terminated) and tagging for each sentence
+   * @param  doc      input document
+   * @param  len      length of document in bytes
+   * @param  opt_str  option string
+   * @return          tagged result. JSON format
+   */
+  virtual const std::string& pos_tag_doc(const char* doc, size_t len, const char* opt_str) = 0;
 };
 
 
@@ -14,6 +14,15 @@
 #define HANAL_VERSION "0.1"
 
 
+//////////////
+// includes //
+//////////////
+#include <stddef.h>    // size_t
+#ifndef __cplusplus
+#include <uchar.h>    // char16_t, char32_t
+#endif
+
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -55,6 +64,58 @@ void hanal_close(int handle);
 const char* hanal_pos_tag(int handle, const char* sent, const char* opt_str);
 
 
+/**
+ * @brief           part-of-speech tagging for text with length (not necessarily null terminated)
+ * @param  handle   handle got from open
+ * @param  sent     input sentence
+ * @param  len      length of sentence in bytes
+ * @param  opt_str  option string
+ * @return          tagged result. JSON format
+ */
+const char* hanal_pos_tag_len(int handle, const char* sent, size_t len, const char* opt_str);
+
+
+/**
+ * @brief           part-of-speech tagging for UTF-16 text. offsets are in UTF-16 code units
+ * @param  handle   handle got from open
+ * @param  sent     input sentence (null terminated)
+ * @param  opt_str  option string
+ * @return          tagged result. JSON format
+ */
+const char* hanal_pos_tag_u16(int handle, const char16_t* sent, const char* opt_str);
+
+
+/**
+ * @brief           part-of-speech tagging for UTF-32 text. offsets are in code points
+ * @param  handle   handle got from open
+ * @param  sent     input sentence (null terminated)
+ * @param  opt_str  option string
+ * @return          tagged result. JSON format
+ */
+const char* hanal_pos_tag_u32(int handle, const char32_t* sent, const char* opt_str);
+
+
+/**
+ * @brief           split document into sentences and part-of-speech tagging for each sentence
+ * @param  handle   handle got from open
+ * @param  doc      input document
+ * @param  opt_str  option string
+ * @return          tagged result. JSON format
+ */
+const char* hanal_pos_tag_doc(int handle, const char* doc, const char* opt_str);
+
+
+/**
+ * @brief           split document with length (not necessarily null terminated) and tagging for each sentence
+ * @param  handle   handle got from open
+ * @param  doc      input document
+ * @param  len      length of document in bytes
+ * @param  opt_str  option string
+ * @return          tagged result. JSON format
+ */
+const char* hanal_pos_tag_doc_len(int handle, const char* doc, size_t len, const char* opt_str);
+
+
 #ifdef __cplusplus
 }    // __cplusplus
 #endif
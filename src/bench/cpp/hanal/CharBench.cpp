@@ -0,0 +1,96 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+//////////////
+// includes //
+//////////////
+#include <algorithm>
+#include <chrono>    // NOLINT
+#include <cstring>
+#include <locale>
+#include <string>
+#include <vector>
+
+#include "boost/log/trivial.hpp"
+#include "gtest/gtest.h"
+#include "hanal/CharBuffer.hpp"
+#include "hanal/Utf8.hpp"
+
+
+/**
+ * benchmark fixture for Char
+ */
+class CharBench: public testing::Test {
+ protected:
+  virtual void SetUp() {
+    // mixed Hangul, Latin, numbers and symbols. about 1MB
+    const char* sent = u8"아버지가 방에 들어가신다. Hanal은 2015년에 시작된 형태소 분석기입니다! (テスト) 　";
+    while (text.size() < (1 << 20)) text += sent;
+  }
+
+  /**
+   * @brief         run function repeatedly and log throughput
+   * @param  name   benchmark name
+   * @param  func   function to run
+   */
+  template<typename F>
+  void run(const char* name, F func) {
+    static const int _ITER = 20;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < _ITER; ++i) func();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double mb_per_sec = (static_cast<double>(text.size()) * _ITER / (1 << 20)) / elapsed.count();
+    BOOST_LOG_TRIVIAL(info) << name << ": " << mb_per_sec << " MB/sec";
+  }
+
+  std::string text;    ///< input text
+};
+
+
+TEST_F(CharBench, decode) {
+  std::vector<wchar_t> wchars;
+  std::vector<int> offsets;
+  run("Utf8::decode", [&] () {
+      wchars.clear();
+      offsets.clear();
+      hanal::Utf8::decode(text.c_str(), text.c_str() + text.size(), &wchars, &offsets);
+  });
+
+  std::locale utf8_locale;
+  try {
+    utf8_locale = std::locale("en_US.UTF-8");
+  } catch (std::runtime_error&) {
+    try {
+      utf8_locale = std::locale("C.UTF-8");
+    } catch (std::runtime_error&) {
+      BOOST_LOG_TRIVIAL(info) << "no UTF-8 locale to compare with codecvt facet";
+      return;
+    }
+  }
+  // previous implementation of characterize (one facet call per character)
+  auto& facet = std::use_facet<std::codecvt<wchar_t, char, std::mbstate_t>>(utf8_locale);
+  std::vector<wchar_t> facet_wchars;
+  std::vector<int> facet_offsets;
+  run("codecvt facet", [&] () {
+      facet_wchars.clear();
+      facet_offsets.clear();
+      const char* text_end = text.c_str() + text.size();
+      auto mbst = std::mbstate_t();
+      const char* from_next = nullptr;
+      for (const char* from_curr = text.c_str(); from_curr < text_end; from_curr = from_next) {
+        wchar_t wchar[2] = L"";
+        wchar_t* to_next = nullptr;
+        facet.in(mbst, from_curr, std::min(from_curr + 6, text_end), from_next, wchar, wchar + 1, to_next);
+        facet_wchars.emplace_back(wchar[0]);
+        facet_offsets.emplace_back(from_curr - text.c_str());
+      }
+  });
+  EXPECT_EQ(facet_wchars, wchars);
+  EXPECT_EQ(facet_offsets, offsets);
+
+  hanal::CharBuffer chars;
+  run("CharBuffer::characterize", [&] () { chars.characterize(text.c_str()); });
+}
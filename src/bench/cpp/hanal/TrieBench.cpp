@@ -0,0 +1,283 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+//////////////
+// includes //
+//////////////
+#include <algorithm>
+#include <chrono>    // NOLINT
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "boost/locale.hpp"
+#include "boost/log/trivial.hpp"
+#include "gtest/gtest.h"
+#include "hanal/CharBuffer.hpp"
+#include "hanal/DicBuilder.hpp"
+#include "hanal/Trie.hpp"
+#include "hanal/TrieBuilder.hpp"
+
+
+/////////////
+// externs //
+/////////////
+extern std::map<std::string, std::string> prog_args;
+
+
+/**
+ * least recently used cache simulator which counts misses
+ */
+class LruSim {
+ public:
+  explicit LruSim(size_t capacity): _capacity(capacity) {}    ///< ctor with number of entries
+
+  void access(size_t key) {    ///< access entry with key
+    auto found = _entries.find(key);
+    if (found != _entries.end()) {
+      _order.splice(_order.begin(), _order, found->second);
+      return;
+    }
+    misses += 1;
+    _order.push_front(key);
+    _entries[key] = _order.begin();
+    if (_order.size() <= _capacity) return;
+    _entries.erase(_order.back());
+    _order.pop_back();
+  }
+
+  uint64_t misses = 0;    ///< number of misses
+
+ private:
+  size_t _capacity;    ///< number of entries
+  std::list<size_t> _order;    ///< keys in order of recent access
+  std::unordered_map<size_t, std::list<size_t>::iterator> _entries;    ///< entries in cache
+};
+
+
+/**
+ * benchmark fixture for common prefix search of morph_trie with words of Sejong sample documents
+ */
+class TrieBench: public testing::Test {
+ protected:
+  virtual void SetUp() {
+    auto iter = prog_args.find("rsc-dir");
+    if (iter == prog_args.end()) FAIL() << "--rsc-dir argument required";
+    morph_trie_path = prog_args["rsc-dir"] + "/morph.trie";
+    morph_trie.open(morph_trie_path);
+
+    std::string sample_dir = "../src/main/scripts";
+    if (prog_args.count("sample-dir") > 0) sample_dir = prog_args["sample-dir"];
+    std::string doc;
+    for (auto name : {"sejong_tagged.spoken.sample.utf-16le", "sejong_tagged.written.sample.utf-16le"}) {
+      std::ifstream fin(sample_dir + "/" + name, std::ios::binary);
+      ASSERT_TRUE(fin.good()) << "sample not found (use --sample-dir option): " << sample_dir << "/" << name;
+      std::string bytes((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+      std::u16string utf16;
+      for (size_t idx = 0; idx + 1 < bytes.size(); idx += 2) {
+        utf16 += static_cast<char16_t>(static_cast<uint8_t>(bytes[idx]) | (static_cast<uint8_t>(bytes[idx + 1]) << 8));
+      }
+      if (!utf16.empty() && utf16[0] == 0xFEFF) utf16.erase(0, 1);    // BOM
+      doc += boost::locale::conv::utf_to_utf<char>(utf16);
+    }
+    chars.characterize(doc.c_str());
+    std::replace(doc.begin(), doc.end(), '\t', ' ');    // as a profile of "text" lines
+    profile = doc;
+  }
+
+  /**
+   * @brief  read whole binary file
+   */
+  template<typename T>
+  std::vector<T> read(std::string path) {
+    std::ifstream fin(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+    std::vector<T> data(bytes.size() / sizeof(T));
+    std::copy(bytes.begin(), bytes.end(), reinterpret_cast<char*>(data.data()));
+    return data;
+  }
+
+  /**
+   * @brief        replay searches of run() on legacy trie (root jump table and binary search like Trie) and its values,
+   *               then log distinct pages touched (working set) and miss rates of small LRU caches
+   * @param  stem  stem of dictionary files (.trie, .val and .val.len)
+   */
+  void log_locality(std::string stem) {
+    static const size_t _PAGE = 4096;
+    static const size_t _LINE = 64;
+    static const size_t _VAL_BASE = static_cast<size_t>(1) << 40;    // separates addresses of values from nodes
+    auto nodes = read<hanal::_trie_node_t>(stem + ".trie");
+    auto lens = read<int16_t>(stem + ".val.len");
+    std::vector<size_t> val_offsets(lens.size() + 1, 0);
+    for (int idx = 0; idx < lens.size(); ++idx) val_offsets[idx + 1] = val_offsets[idx] + lens[idx] * sizeof(wchar_t);
+    std::set<size_t> trie_pages;
+    std::set<size_t> val_pages;
+    LruSim page_lru(32);    // 128KB
+    LruSim line_lru(512);    // 32KB
+    uint64_t access_num = 0;
+    auto touch = [&] (size_t addr, size_t size) {
+      for (size_t line = addr / _LINE; line <= (addr + size - 1) / _LINE; ++line) {
+        line_lru.access(line);
+        ++access_num;
+      }
+      for (size_t page = addr / _PAGE; page <= (addr + size - 1) / _PAGE; ++page) {
+        page_lru.access(page);
+        (addr >= _VAL_BASE ? val_pages : trie_pages).insert(page);
+      }
+    };
+    auto touch_node = [&] (const hanal::_trie_node_t* node) {
+      touch((node - nodes.data()) * sizeof(hanal::_trie_node_t), sizeof(hanal::_trie_node_t));
+    };
+    std::map<wchar_t, int> root_children;    // jump table of Trie
+    for (int idx = nodes[0].child_start; idx < nodes[0].child_start + nodes[0].child_num; ++idx) {
+      root_children[nodes[idx].ch] = idx;
+    }
+    run(stem.c_str(), [&] (const wchar_t* text, int len) {
+      int match_num = 0;
+      const hanal::_trie_node_t* node = nodes.data();
+      for (int idx = 0; idx < len; ++idx) {
+        if (node == nodes.data()) {
+          auto found = root_children.find(text[idx]);
+          if (found == root_children.end()) break;
+          node = &nodes[found->second];
+          touch_node(node);
+        } else {
+          if (node->child_start <= 0) break;
+          auto begin = node + node->child_start;
+          auto end = begin + node->child_num;
+          auto found = std::lower_bound(begin, end, text[idx], [&] (const hanal::_trie_node_t& child, wchar_t ch) {
+              touch_node(&child);
+              return child.ch < ch;
+          });
+          if (found == end || found->ch != text[idx]) break;
+          node = found;
+          touch_node(node);
+        }
+        if (node->val_idx < 0) continue;
+        touch(_VAL_BASE + val_offsets[node->val_idx], val_offsets[node->val_idx + 1] - val_offsets[node->val_idx]);
+        ++match_num;
+      }
+      return match_num;
+    });
+    BOOST_LOG_TRIVIAL(info) << stem << ": working set " << trie_pages.size() << " trie pages and " << val_pages.size()
+                            << " value pages, miss rate " << (100.0 * page_lru.misses / access_num)
+                            << "% of pages in 128KB LRU, " << (100.0 * line_lru.misses / access_num)
+                            << "% of lines in 32KB LRU";
+  }
+
+  /**
+   * @brief         search common prefix matches from every character to end of its word and log throughput
+   * @param  name   benchmark name
+   * @param  func   function to search with (text, len) which returns number of matches
+   * @return        total number of matches
+   */
+  template<typename F>
+  int run(const char* name, F func) {
+    static const int _ITER = 10;
+    int match_num = 0;
+    int lookup_num = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < _ITER; ++i) {
+      int word_end = chars.size();
+      for (int idx = chars.size() - 1; idx >= 0; --idx) {
+        match_num += func(&chars.wchars[idx], word_end - idx);
+        ++lookup_num;
+        if (chars.is_word_start(idx)) word_end = idx;
+      }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    BOOST_LOG_TRIVIAL(info) << name << ": " << (lookup_num / elapsed.count()) << " lookups/sec";
+    return match_num / _ITER;
+  }
+
+  std::string morph_trie_path;    ///< path of morph.trie
+  hanal::Trie morph_trie;    ///< morph trie
+  hanal::CharBuffer chars;    ///< characters of sample documents
+  std::string profile;    ///< sample documents as a frequency profile
+};
+
+
+TEST_F(TrieBench, search_common_prefix_matches) {
+  if (morph_trie.format() != hanal::Trie::Format::LEGACY) return;
+  int accel_num = run("root jump table and binary search", [&] (const wchar_t* text, int len) {
+      return static_cast<int>(morph_trie.search_common_prefix_matches(text, len).size());
+  });
+  int visitor_num = run("without allocation", [&] (const wchar_t* text, int len) {
+      return morph_trie.search_common_prefix_matches(text, len, [] (const hanal::Trie::match_t&) {});
+  });
+  EXPECT_EQ(accel_num, visitor_num);
+
+  // previous way: linear scan over siblings at every level
+  std::ifstream fin(morph_trie_path, std::ios::binary);
+  std::string bytes((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+  std::vector<hanal::_trie_node_t> nodes(bytes.size() / sizeof(hanal::_trie_node_t));
+  std::copy(bytes.begin(), bytes.end(), reinterpret_cast<char*>(nodes.data()));
+  int linear_num = run("linear scan", [&] (const wchar_t* text, int len) {
+      std::list<hanal::Trie::match_t> found_list;
+      const hanal::_trie_node_t* node = nodes.data();
+      for (int idx = 0; idx < len; ++idx) {
+        if (node->child_start <= 0) break;
+        auto begin = node + node->child_start;
+        auto end = begin + node->child_num;
+        auto found = std::find_if(begin, end, [&] (const hanal::_trie_node_t& child) { return child.ch == text[idx]; });
+        if (found == end) break;
+        node = found;
+        if (node->val_idx >= 0) found_list.emplace_back(idx + 1, node->val_idx);
+      }
+      return static_cast<int>(found_list.size());
+  });
+  EXPECT_EQ(linear_num, accel_num);
+}
+
+
+TEST_F(TrieBench, formats) {
+  std::string packed_path = "TrieBench.morph.packed.trie";    // in current directory
+  std::string da_path = "TrieBench.morph.da.trie";
+  std::string dawg_path = "TrieBench.morph.dawg.trie";
+  hanal::TrieBuilder::to_packed(morph_trie_path, packed_path);
+  hanal::TrieBuilder::to_double_array(morph_trie_path, da_path);
+  hanal::TrieBuilder::to_dawg(morph_trie_path, dawg_path);
+  std::vector<int> match_nums;
+  for (auto path : {morph_trie_path, packed_path, da_path, dawg_path}) {
+    hanal::Trie trie;
+    trie.open(path);
+    std::ifstream fin(path, std::ios::binary | std::ios::ate);
+    BOOST_LOG_TRIVIAL(info) << path << ": " << fin.tellg() << " bytes";
+    match_nums.emplace_back(run(path.c_str(), [&] (const wchar_t* text, int len) {
+        return trie.search_common_prefix_matches(text, len, [] (const hanal::Trie::match_t&) {});
+    }));
+  }
+  EXPECT_EQ(match_nums[0], match_nums[1]);
+  EXPECT_EQ(match_nums[0], match_nums[2]);
+  EXPECT_EQ(match_nums[0], match_nums[3]);
+  std::remove(packed_path.c_str());
+  std::remove(da_path.c_str());
+  std::remove(dawg_path.c_str());
+}
+
+
+TEST_F(TrieBench, layout) {
+  if (morph_trie.format() != hanal::Trie::Format::LEGACY) return;
+  std::string stem = morph_trie_path.substr(0, morph_trie_path.length() - 5);
+  std::string hot_stem = "TrieBench.morph.hot";    // in current directory
+  for (auto ext : {".trie", ".val", ".val.len"}) {
+    std::ifstream fin(stem + ext, std::ios::binary);
+    std::ofstream fout(hot_stem + ext, std::ios::binary);
+    fout << fin.rdbuf();
+  }
+  std::istringstream sin(profile);
+  hanal::DicBuilder::layout_morph(hot_stem, sin);
+  log_locality(stem);
+  log_locality(hot_stem);
+  for (auto ext : {".trie", ".val", ".val.len"}) std::remove((hot_stem + ext).c_str());
+}
@@ -0,0 +1,111 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+//////////////
+// includes //
+//////////////
+#include <chrono>    // NOLINT
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "boost/locale.hpp"
+#include "boost/log/trivial.hpp"
+#include "gtest/gtest.h"
+#include "hanal/Char.hpp"
+#include "hanal/CharBuffer.hpp"
+#include "hanal/Utf8.hpp"
+#include "hanal/Word.hpp"
+
+
+/////////////
+// externs //
+/////////////
+extern std::map<std::string, std::string> prog_args;
+
+
+/**
+ * benchmark fixture for word tokenization over Sejong sample documents
+ */
+class WordBench: public testing::Test {
+ protected:
+  virtual void SetUp() {
+    std::string sample_dir = "../src/main/scripts";
+    if (prog_args.count("sample-dir") > 0) sample_dir = prog_args["sample-dir"];
+    for (auto name : {"sejong_tagged.spoken.sample.utf-16le", "sejong_tagged.written.sample.utf-16le"}) {
+      std::ifstream fin(sample_dir + "/" + name, std::ios::binary);
+      ASSERT_TRUE(fin.good()) << "sample not found (use --sample-dir option): " << sample_dir << "/" << name;
+      std::string bytes((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+      std::u16string utf16;
+      for (size_t idx = 0; idx + 1 < bytes.size(); idx += 2) {
+        utf16 += static_cast<char16_t>(static_cast<uint8_t>(bytes[idx]) | (static_cast<uint8_t>(bytes[idx + 1]) << 8));
+      }
+      if (!utf16.empty() && utf16[0] == 0xFEFF) utf16.erase(0, 1);    // BOM
+      doc += boost::locale::conv::utf_to_utf<char>(utf16);
+    }
+    // repeat to about 4MB document
+    std::string sample = doc;
+    while (doc.size() < (4 << 20)) doc += sample;
+  }
+
+  /**
+   * @brief         run function repeatedly and log throughput
+   * @param  name   benchmark name
+   * @param  func   function to run
+   */
+  template<typename F>
+  void run(const char* name, F func) {
+    static const int _ITER = 10;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < _ITER; ++i) func();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double mb_per_sec = (static_cast<double>(doc.size()) * _ITER / (1 << 20)) / elapsed.count();
+    BOOST_LOG_TRIVIAL(info) << name << ": " << mb_per_sec << " MB/sec";
+  }
+
+  std::string doc;    ///< UTF-8 document
+};
+
+
+TEST_F(WordBench, scan_words) {
+  std::vector<hanal::Utf8::span_t> spans;
+  run("Utf8::scan_words", [&] () { hanal::Utf8::scan_words(doc.c_str(), doc.c_str() + doc.size(), &spans); });
+
+  // previous way: decode every character and check white space one by one
+  std::vector<wchar_t> wchars;
+  std::vector<int> offsets;
+  std::vector<hanal::Utf8::span_t> decoded_spans;
+  run("decode and Char::is_space", [&] () {
+      wchars.clear();
+      offsets.clear();
+      decoded_spans.clear();
+      hanal::Utf8::decode(doc.c_str(), doc.c_str() + doc.size(), &wchars, &offsets);
+      bool in_word = false;
+      for (size_t idx = 0; idx < wchars.size(); ++idx) {
+        bool is_space = hanal::Char::is_space(wchars[idx]);
+        if (in_word && is_space) {
+          decoded_spans.back().end = offsets[idx];
+        } else if (!in_word && !is_space) {
+          decoded_spans.emplace_back(offsets[idx], doc.size());
+        }
+        in_word = !is_space;
+      }
+  });
+  ASSERT_EQ(decoded_spans.size(), spans.size());
+  for (size_t idx = 0; idx < spans.size(); ++idx) {
+    EXPECT_EQ(decoded_spans[idx].begin, spans[idx].begin);
+    EXPECT_EQ(decoded_spans[idx].end, spans[idx].end);
+  }
+}
+
+
+TEST_F(WordBench, tokenize) {
+  hanal::CharBuffer chars;
+  run("CharBuffer::characterize", [&] () { chars.characterize(doc.c_str()); });
+  run("Word::tokenize", [&] () { hanal::Word::tokenize(doc.c_str(), &chars); });
+}
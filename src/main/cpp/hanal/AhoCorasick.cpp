@@ -0,0 +1,79 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#include "hanal/AhoCorasick.hpp"
+
+
+//////////////
+// includes //
+//////////////
+#include <vector>
+
+#include "boost/log/trivial.hpp"
+#include "hanal/Except.hpp"
+
+
+namespace hanal {
+
+
+/////////////
+// methods //
+/////////////
+void AhoCorasick::build(const Trie& trie) {
+  clear();
+  HANAL_ASSERT(trie.format() == Trie::Format::LEGACY || trie.format() == Trie::Format::PACKED,
+               "Aho-Corasick automaton requires legacy or packed trie");
+  HANAL_ASSERT(trie._node_num > 0, "Trie is not opened");
+  _trie = &trie;
+  _failure.assign(trie._node_num, 0);
+  _output.assign(trie._node_num, -1);
+  _depth.assign(trie._node_num, 0);
+  // visit states in breadth first order, so failure states (shallower) are always done before their children.
+  // node order of trie is not breadth first after layout
+  std::vector<int> queue;
+  queue.reserve(trie._node_num);
+  queue.emplace_back(0);
+  for (size_t head = 0; head < queue.size(); ++head) {
+    int node = queue[head];
+    int first = -1;
+    int child_num = trie._children(node, &first);
+    for (int child = first; child_num > 0 && child < first + child_num; ++child) {
+      _depth[child] = _depth[node] + 1;
+      if (node > 0) _failure[child] = _next(_failure[node], trie._char(child));
+      int failure = _failure[child];
+      _output[child] = (trie._value(failure) >= 0) ? failure : _output[failure];
+      queue.emplace_back(child);
+    }
+  }
+  HANAL_ASSERT(queue.size() == trie._node_num, "Some states of trie are not reachable from root");
+  BOOST_LOG_TRIVIAL(info) << "Aho-Corasick automaton built with " << trie._node_num << " states";
+}
+
+
+void AhoCorasick::clear() {
+  _trie = nullptr;
+  _failure.clear();
+  _output.clear();
+  _depth.clear();
+}
+
+
+bool AhoCorasick::empty() const {
+  return _trie == nullptr;
+}
+
+
+int AhoCorasick::_next(int state, wchar_t ch) const {
+  for (;;) {
+    int next = _trie->_child(state, ch);
+    if (next >= 0) return next;
+    if (state == 0) return 0;
+    state = _failure[state];
+  }
+}
+
+
+}    // namespace hanal
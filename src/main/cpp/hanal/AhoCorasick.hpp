@@ -0,0 +1,81 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#ifndef HANAL_AHOCORASICK_HPP
+#define HANAL_AHOCORASICK_HPP
+
+
+//////////////
+// includes //
+//////////////
+#include <cstdint>
+#include <vector>
+
+#include "hanal/Trie.hpp"
+
+
+namespace hanal {
+
+
+/**
+ * Aho-Corasick automaton on trie. nodes of trie are states and failure links are added to find all entries in text
+ * with one left to right pass
+ */
+class AhoCorasick {
+ public:
+  /**
+   * @brief        build failure links on opened trie (legacy or packed format)
+   * @param  trie  trie which must be kept open while the automaton is used
+   */
+  void build(const Trie& trie);
+
+  void clear();    ///< clear automaton
+
+  bool empty() const;    ///< whether automaton is built or not
+
+  /**
+   * @brief            search all entries in text
+   * @param   text     text to search (not necessarily zero terminated)
+   * @param   len      length of text
+   * @param   visitor  function called with (end position, const Trie::match_t&) for each match. matches ending at
+   *                   the same position are visited from the longest one
+   * @return           number of matches
+   */
+  template<typename V>
+  int search(const wchar_t* text, int len, V visitor) const {
+    HANAL_ASSERT(text != nullptr, "Null text");
+    int match_num = 0;
+    int state = 0;
+    for (int idx = 0; idx < len; ++idx) {
+      state = _next(state, text[idx]);
+      for (int found = (_trie->_value(state) >= 0) ? state : _output[state]; found > 0; found = _output[found]) {
+        visitor(idx + 1, Trie::match_t(_depth[found], _trie->_value(found)));
+        ++match_num;
+      }
+    }
+    return match_num;
+  }
+
+ private:
+  const Trie* _trie = nullptr;    ///< trie
+  std::vector<int32_t> _failure;    ///< failure link (longest proper suffix state) of each state
+  std::vector<int32_t> _output;    ///< longest proper suffix state with value. -1 if none
+  std::vector<int32_t> _depth;    ///< depth (length of key) of each state
+
+  /**
+   * @brief         transition with failure links
+   * @param  state  current state
+   * @param  ch     character
+   * @return        next state (0 for root)
+   */
+  int _next(int state, wchar_t ch) const;
+};
+
+
+}    // namespace hanal
+
+
+#endif  // HANAL_AHOCORASICK_HPP
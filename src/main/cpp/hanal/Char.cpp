@@ -10,11 +10,11 @@
 //////////////
 // includes //
 //////////////
-#include <locale>
+#include <algorithm>
+#include <array>
+#include <cwchar>
 #include <string>
-#include <vector>
 
-#include "boost/lexical_cast.hpp"
 #include "hanal/Except.hpp"
 
 
@@ -25,73 +25,43 @@ namespace hanal {
 // static members //
 ////////////////////
 const std::wstring Char::SPACE = L" \t\v\r\n\u3000";
+const Char::_class_table_t Char::_CLASS_TABLE;    // must be initialized after SPACE
 
 
 ////////////////////
 // ctors and dtor //
 ////////////////////
-Char::Char(wchar_t wchar_, const char* start_, const char* end_)
-    : wchar(wchar_), start(start_), end(end_) {
+Char::_class_table_t::_class_table_t() {
+  std::array<uint8_t, 256> block;
+  for (int upper = 0; upper < 256; ++upper) {
+    for (int lower = 0; lower < 256; ++lower) {
+      auto type = _type(static_cast<wchar_t>((upper << 8) | lower));
+      block[lower] = static_cast<uint8_t>(type) | (static_cast<uint8_t>(merge_strategy(type)) << 4);
+    }
+    // share same blocks (most of blocks are filled with single class)
+    int block_num = blocks.size() / 256;
+    int found = 0;
+    for (; found < block_num; ++found) {
+      if (std::equal(block.begin(), block.end(), blocks.begin() + found * 256)) break;
+    }
+    if (found == block_num) blocks.insert(blocks.end(), block.begin(), block.end());
+    block_idx[upper] = found;
+  }
 }
 
 
 /////////////
 // methods //
 /////////////
-SHDPTRVEC(Char) Char::characterize(const char* text) {
-  HANAL_ASSERT(text != nullptr, "Null text to characteraize");
-  auto en_US_utf8 = std::locale("en_US.UTF-8");
-  auto& facet = std::use_facet<std::codecvt<wchar_t, char, std::mbstate_t>>(en_US_utf8);
-  auto mbst = std::mbstate_t();
-  const char* from_next = nullptr;
-  SHDPTRVEC(Char) chars;
-  for (const char* from_curr = text; *from_curr != '\0'; from_curr = from_next) {
-    wchar_t wchar[2] = L"";
-    wchar_t* to_next = nullptr;
-    auto result = facet.in(mbst, from_curr, from_curr + 6, from_next, wchar, wchar + 1, to_next);
-    HANAL_ASSERT(result == std::codecvt_base::partial || result == std::codecvt_base::ok,
-                 "Fail to convert character at position: " + boost::lexical_cast<std::string>(from_next - from_curr));
-    chars.emplace_back(std::make_shared<Char>(wchar[0], from_curr, from_next));
-  }
-  return chars;
-}
-
-
-bool Char::is_space() {
-  if (is_space(wchar)) _type = Type::SPACE;
-  return _type == Type::SPACE;
-}
-
-
-Char::Type Char::type() {
-  if (_type == Type::UNK) {
-    if (is_space(wchar)) {
-      _type = Type::SPACE;
-    } else if (is_hangul(wchar)) {
-      _type = Type::HANGUL;
-    } else if (is_latin(wchar)) {
-      _type = Type::LATIN;
-    } else if (is_number(wchar)) {
-      _type = Type::NUMBER;
-    } else if (is_cjk(wchar)) {
-      _type = Type::CJK;
-    } else if (is_ellipsis(wchar)) {
-      _type = Type::ELLIPSIS;
-    } else if (is_period(wchar)) {
-      _type = Type::PERIOD;
-    } else if (is_o_mark(wchar)) {
-      _type = Type::O_MARK;
-    } else if (is_comma(wchar)) {
-      _type = Type::COMMA;
-    } else if (is_quote(wchar)) {
-      _type = Type::QUOTE;
-    } else if (is_symbol(wchar)) {
-      _type = Type::SYMBOL;
-    } else {
-      _type = Type::FOREIGN;
-    }
+Char::Type Char::type(wchar_t wchar) {
+  return static_cast<Type>(_class(wchar) & 0x0F);
+}
+
+
+void Char::classify(const wchar_t* wchars, size_t size, Type* types) {
+  for (size_t idx = 0; idx < size; ++idx) {
+    types[idx] = static_cast<Type>(_class(wchars[idx]) & 0x0F);
   }
-  return _type;
 }
 
 
@@ -107,8 +77,48 @@ Char::MergeStrategy Char::merge_strategy(Type type) {
 }
 
 
-SejongTag Char::estimate_pos_tag() {
-  return estimate_pos_tag(type());
+Char::MergeStrategy Char::merge_strategy(wchar_t wchar) {
+  return static_cast<MergeStrategy>(_class(wchar) >> 4);
+}
+
+
+uint8_t Char::_class(wchar_t wchar) {
+  auto code = static_cast<uint32_t>(wchar);
+  if (code > 0xFFFF) {
+    // supplementary planes (cold path)
+    auto type = _type(wchar);
+    return static_cast<uint8_t>(type) | (static_cast<uint8_t>(merge_strategy(type)) << 4);
+  }
+  return _CLASS_TABLE.blocks[(_CLASS_TABLE.block_idx[code >> 8] << 8) | (code & 0xFF)];
+}
+
+
+Char::Type Char::_type(wchar_t wchar) {
+  if (is_space(wchar)) {
+    return Type::SPACE;
+  } else if (is_hangul(wchar)) {
+    return Type::HANGUL;
+  } else if (is_latin(wchar)) {
+    return Type::LATIN;
+  } else if (is_number(wchar)) {
+    return Type::NUMBER;
+  } else if (is_cjk(wchar)) {
+    return Type::CJK;
+  } else if (is_ellipsis(wchar)) {
+    return Type::ELLIPSIS;
+  } else if (is_period(wchar)) {
+    return Type::PERIOD;
+  } else if (is_o_mark(wchar)) {
+    return Type::O_MARK;
+  } else if (is_comma(wchar)) {
+    return Type::COMMA;
+  } else if (is_quote(wchar)) {
+    return Type::QUOTE;
+  } else if (is_symbol(wchar)) {
+    return Type::SYMBOL;
+  } else {
+    return Type::FOREIGN;
+  }
 }
 
 
@@ -11,11 +11,11 @@
 //////////////
 // includes //
 //////////////
-#include <memory>
+#include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 
-#include "hanal/macro.hpp"
 #include "hanal/SejongTag.hpp"
 
 
@@ -52,21 +52,20 @@ class Char {
 
   static const std::wstring SPACE;    ///< space characters
 
-  wchar_t wchar = L'\0';    ///< converted wide character
-  const char* start = nullptr;    ///< start position (zero based, inclusive) of original UTF-8 text
-  const char* end = nullptr;    ///< end position (exclusive) of original UTF-8 text
-
-  Char(wchar_t wchar_, const char* start_, const char* end_);    ///< ctor
-
   /**
-   * @brief        tokenize UTF-8 text into words
-   * @param  text  input text
-   * @return       vector of words
+   * @brief         get character type
+   * @param  wchar  wide character
+   * @return        character type
    */
-  static SHDPTRVEC(Char) characterize(const char* text);
+  static Type type(wchar_t wchar);
 
-  bool is_space();    ///< whether is space or not
-  Type type();    ///< get character type
+  /**
+   * @brief          get character types of characters at once
+   * @param  wchars  wide characters
+   * @param  size    number of characters
+   * @param  types   [out] character types
+   */
+  static void classify(const wchar_t* wchars, size_t size, Type* types);
 
   /**
    * @brief        get character merge strategy when estimating unknown words
@@ -76,10 +75,11 @@ class Char {
   static MergeStrategy merge_strategy(Type type);
 
   /**
-   * @brief   get estimated part-of-speech tag
-   * @return  part-of-speech tag
+   * @brief         get character merge strategy when estimating unknown words
+   * @param  wchar  wide character
+   * @return        strategy
    */
-  SejongTag estimate_pos_tag();
+  static MergeStrategy merge_strategy(wchar_t wchar);
 
   /**
    * @brief        get part-of-speech tag with character type
@@ -102,7 +102,30 @@ class Char {
   static bool is_symbol(wchar_t wchar);    ///< whether is symbol or not
 
  private:
-  Type _type = Type::UNK;    ///< character type
+  /**
+   * two-level lookup table of character class (type at lower 4 bits and merge strategy at upper bits) for BMP
+   */
+  struct _class_table_t {
+    std::array<uint16_t, 256> block_idx;    ///< block index for upper 8 bits of character
+    std::vector<uint8_t> blocks;    ///< distinct blocks of 256 classes for lower 8 bits of character
+    _class_table_t();    ///< ctor. build table with is_*() predicates
+  };
+
+  static const _class_table_t _CLASS_TABLE;    ///< character class table
+
+  /**
+   * @brief         get character class (type and merge strategy) with table
+   * @param  wchar  wide character
+   * @return        character class
+   */
+  static uint8_t _class(wchar_t wchar);
+
+  /**
+   * @brief         get character type with is_*() predicates (slow path)
+   * @param  wchar  wide character
+   * @return        character type
+   */
+  static Type _type(wchar_t wchar);
 };
 
 
@@ -0,0 +1,219 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#include "hanal/CharBuffer.hpp"
+
+
+//////////////
+// includes //
+//////////////
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "boost/lexical_cast.hpp"
+
+#include "hanal/Except.hpp"
+#include "hanal/Jamo.hpp"
+#include "hanal/Utf8.hpp"
+
+
+namespace hanal {
+
+
+///////////////
+// functions //
+///////////////
+/**
+ * @brief          decode UTF-16 text
+ * @param  text    text
+ * @param  len     length of text (in code units)
+ * @param  wchars  [out] decoded wide characters
+ * @param  starts  [out] start positions (code unit offset) of characters
+ */
+static void _decode_utf16(const char16_t* text, int len, std::vector<wchar_t>* wchars, std::vector<int>* starts) {
+  for (int pos = 0; pos < len; ++pos) {
+    uint32_t code = text[pos];
+    int start = pos;
+    if (0xD800 <= code && code <= 0xDBFF && pos + 1 < len && 0xDC00 <= text[pos + 1] && text[pos + 1] <= 0xDFFF) {
+      code = 0x10000 + ((code - 0xD800) << 10) + (text[pos + 1] - 0xDC00);
+      pos += 1;
+    } else {
+      HANAL_ASSERT(code < 0xD800 || code > 0xDFFF,
+                   "Fail to convert character at position: " + boost::lexical_cast<std::string>(pos));
+    }
+    wchars->emplace_back(static_cast<wchar_t>(code));
+    starts->emplace_back(start);
+  }
+}
+
+
+/**
+ * @brief          convert UTF-32 text
+ * @param  text    text
+ * @param  len     length of text (in code points)
+ * @param  wchars  [out] converted wide characters
+ * @param  starts  [out] start positions (code point offset) of characters
+ */
+static void _decode_utf32(const char32_t* text, int len, std::vector<wchar_t>* wchars, std::vector<int>* starts) {
+  for (int pos = 0; pos < len; ++pos) {
+    uint32_t code = text[pos];
+    HANAL_ASSERT(code <= 0x10FFFF && (code < 0xD800 || code > 0xDFFF),
+                 "Fail to convert character at position: " + boost::lexical_cast<std::string>(pos));
+    wchars->emplace_back(static_cast<wchar_t>(code));
+    starts->emplace_back(pos);
+  }
+}
+
+
+/////////////
+// methods //
+/////////////
+void CharBuffer::characterize(const char* text_) {
+  HANAL_ASSERT(text_ != nullptr, "Null text to characteraize");
+  characterize(text_, strlen(text_));
+}
+
+
+void CharBuffer::characterize(const char* text_, size_t len) {
+  HANAL_ASSERT(text_ != nullptr, "Null text to characteraize");
+  HANAL_ASSERT(len <= INT_MAX, "Too long text to characterize: " + boost::lexical_cast<std::string>(len));
+  clear();
+  text = text_;
+  wchars.reserve(len);
+  starts.reserve(len);
+  ends.reserve(len);
+
+  // white spaces are skipped at byte level, so only characters in words are decoded
+  Utf8::scan_words(text, text + len, &_word_spans);
+  for (auto& span : _word_spans) {
+    int first = wchars.size();
+    Utf8::decode(text + span.begin, text + span.end, &wchars, &starts, span.begin);
+    int last = wchars.size() - 1;
+    ends.resize(last + 1);
+    bool has_jamo = Jamo::is_conjoining(wchars[last]);
+    for (int idx = first; idx < last; ++idx) {
+      ends[idx] = starts[idx + 1];
+      has_jamo |= Jamo::is_conjoining(wchars[idx]);
+    }
+    ends[last] = span.end;
+    if (has_jamo) _compose_jamo(first);
+  }
+  types.resize(wchars.size());
+  Char::classify(wchars.data(), wchars.size(), types.data());
+}
+
+
+void CharBuffer::characterize(const char16_t* text_) {
+  HANAL_ASSERT(text_ != nullptr, "Null text to characteraize");
+  characterize(text_, std::char_traits<char16_t>::length(text_));
+}
+
+
+void CharBuffer::characterize(const char16_t* text_, size_t len) {
+  HANAL_ASSERT(text_ != nullptr, "Null text to characteraize");
+  HANAL_ASSERT(len <= INT_MAX, "Too long text to characterize: " + boost::lexical_cast<std::string>(len));
+  clear();
+  _decode_utf16(text_, len, &wchars, &starts);
+  _remove_spaces(len);
+}
+
+
+void CharBuffer::characterize(const char32_t* text_) {
+  HANAL_ASSERT(text_ != nullptr, "Null text to characteraize");
+  characterize(text_, std::char_traits<char32_t>::length(text_));
+}
+
+
+void CharBuffer::characterize(const char32_t* text_, size_t len) {
+  HANAL_ASSERT(text_ != nullptr, "Null text to characteraize");
+  HANAL_ASSERT(len <= INT_MAX, "Too long text to characterize: " + boost::lexical_cast<std::string>(len));
+  clear();
+  _decode_utf32(text_, len, &wchars, &starts);
+  _remove_spaces(len);
+}
+
+
+void CharBuffer::clear() {
+  text = nullptr;
+  wchars.clear();
+  starts.clear();
+  ends.clear();
+  types.clear();
+}
+
+
+int CharBuffer::size() const {
+  return wchars.size();
+}
+
+
+bool CharBuffer::is_word_start(int idx) const {
+  return idx == 0 || starts[idx] != ends[idx - 1];
+}
+
+
+void CharBuffer::_remove_spaces(int len) {
+  // end of each character is start of the next one
+  int all_size = wchars.size();
+  types.resize(all_size);
+  Char::classify(wchars.data(), all_size, types.data());
+  ends.resize(all_size);
+  int size = 0;
+  bool has_jamo = false;
+  for (int idx = 0; idx < all_size; ++idx) {
+    if (types[idx] == Char::Type::SPACE) continue;
+    wchars[size] = wchars[idx];
+    starts[size] = starts[idx];
+    ends[size] = (idx + 1 < all_size) ? starts[idx + 1] : len;
+    types[size] = types[idx];
+    has_jamo |= Jamo::is_conjoining(wchars[idx]);
+    size += 1;
+  }
+  wchars.resize(size);
+  starts.resize(size);
+  ends.resize(size);
+  types.resize(size);
+  if (has_jamo) {
+    _compose_jamo(0);
+    types.resize(wchars.size());
+    Char::classify(wchars.data(), wchars.size(), types.data());
+  }
+}
+
+
+void CharBuffer::_compose_jamo(int first) {
+  int all_size = wchars.size();
+  int size = first;
+  for (int idx = first; idx < all_size; ++size) {
+    // jamo are composed within a word
+    int word_len = 1;
+    while (word_len < 3 && idx + word_len < all_size && starts[idx + word_len] == ends[idx + word_len - 1]) {
+      word_len += 1;
+    }
+    wchar_t syllable = L'\0';
+    int jamo_num = Jamo::compose(wchars.data() + idx, word_len, &syllable);
+    if (jamo_num > 0) {
+      wchars[size] = syllable;
+      starts[size] = starts[idx];
+      ends[size] = ends[idx + jamo_num - 1];
+      idx += jamo_num;
+    } else {
+      wchars[size] = wchars[idx];
+      starts[size] = starts[idx];
+      ends[size] = ends[idx];
+      idx += 1;
+    }
+  }
+  wchars.resize(size);
+  starts.resize(size);
+  ends.resize(size);
+}
+
+
+}    // namespace hanal
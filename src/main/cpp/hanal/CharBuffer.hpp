@@ -0,0 +1,106 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#ifndef HANAL_CHARBUFFER_HPP
+#define HANAL_CHARBUFFER_HPP
+
+
+//////////////
+// includes //
+//////////////
+#include <cstddef>
+#include <vector>
+
+#include "hanal/Char.hpp"
+#include "hanal/Utf8.hpp"
+
+
+namespace hanal {
+
+
+/**
+ * characters of a sentence except white spaces. parallel arrays indexed by character index
+ */
+class CharBuffer {
+ public:
+  const char* text = nullptr;    ///< original UTF-8 text (null for UTF-16/UTF-32 text. may not be null terminated)
+  std::vector<wchar_t> wchars;    ///< converted wide characters
+  std::vector<int> starts;    ///< start positions (offset in code units of original text, inclusive)
+  std::vector<int> ends;    ///< end positions (offset in code units of original text, exclusive)
+  std::vector<Char::Type> types;    ///< character types
+
+  /**
+   * @brief        decode UTF-8 text into characters. previous characters are cleared.
+   *               conjoining jamo sequences are composed into syllables spanning all bytes of the jamo
+   * @param  text  input text
+   */
+  void characterize(const char* text_);
+
+  /**
+   * @brief        decode UTF-8 text with length (not necessarily null terminated). previous characters are cleared
+   * @param  text  input text
+   * @param  len   length of text in bytes
+   */
+  void characterize(const char* text_, size_t len);
+
+  /**
+   * @brief        decode UTF-16 text into characters. offsets are in UTF-16 code units
+   * @param  text  input text
+   */
+  void characterize(const char16_t* text_);
+
+  /**
+   * @brief        decode UTF-16 text with length (not necessarily null terminated)
+   * @param  text  input text
+   * @param  len   length of text in code units
+   */
+  void characterize(const char16_t* text_, size_t len);
+
+  /**
+   * @brief        convert UTF-32 text into characters. offsets are in code points
+   * @param  text  input text
+   */
+  void characterize(const char32_t* text_);
+
+  /**
+   * @brief        convert UTF-32 text with length (not necessarily null terminated)
+   * @param  text  input text
+   * @param  len   length of text in code points
+   */
+  void characterize(const char32_t* text_, size_t len);
+
+  void clear();    ///< clear characters (keep allocated memory to reuse)
+
+  int size() const;    ///< number of characters
+
+  /**
+   * @brief       whether the character is the first one of word (white spaces at left)
+   * @param  idx  character index
+   * @return      true if start of word
+   */
+  bool is_word_start(int idx) const;
+
+ private:
+  /**
+   * @brief         compose conjoining jamo sequences into syllables in place
+   * @param  first  index of first character to compose from
+   */
+  void _compose_jamo(int first);
+
+  /**
+   * @brief       remove white spaces from decoded characters and fill ends and types
+   * @param  len  length of original text
+   */
+  void _remove_spaces(int len);
+
+  std::vector<Utf8::span_t> _word_spans;    ///< byte spans of words (reused between sentences)
+};
+
+
+}    // namespace hanal
+
+
+#endif  // HANAL_CHARBUFFER_HPP
@@ -0,0 +1,645 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#include "hanal/DicBuilder.hpp"
+
+
+//////////////
+// includes //
+//////////////
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <string>
+#include <thread>    // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "boost/algorithm/string.hpp"
+#include "boost/lexical_cast.hpp"
+#include "boost/log/trivial.hpp"
+#include "hanal/Except.hpp"
+#include "hanal/MorphDic.hpp"
+#include "hanal/Trie.hpp"
+#include "hanal/Utf8.hpp"
+#include "hanal/Util.hpp"
+
+
+namespace hanal {
+
+
+///////////////
+// functions //
+///////////////
+/**
+ * @brief       write length-prefixed string
+ * @param  out  output stream
+ * @param  str  string
+ */
+static void _write_str(std::ostream& out, const std::string& str) {
+  auto size = static_cast<uint32_t>(str.size());
+  out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  out.write(str.data(), str.size());
+}
+
+
+/**
+ * @brief       read length-prefixed string
+ * @param  in   input stream
+ * @param  str  [out] string
+ * @return      false at the end of stream
+ */
+static bool _read_str(std::istream& in, std::string* str) {
+  uint32_t size = 0;
+  if (!in.read(reinterpret_cast<char*>(&size), sizeof(size))) return false;
+  str->resize(size);
+  in.read(&(*str)[0], size);
+  return true;
+}
+
+
+/**
+ * @brief        decode UTF-8 string into UTF-32 (in bytes)
+ * @param  utf8  UTF-8 string
+ * @param  utf32 [out] UTF-32 string in bytes (appended)
+ * @return       false for invalid UTF-8 sequence
+ */
+static bool _to_utf32(const std::string& utf8, std::string* utf32) {
+  const char* end = utf8.data() + utf8.size();
+  for (const char* pos = utf8.data(); pos < end; ) {
+    wchar_t wchar = L'\0';
+    int len = Utf8::decode_char(pos, end, &wchar);
+    if (len <= 0) return false;
+    auto code = static_cast<int32_t>(wchar);
+    utf32->append(reinterpret_cast<const char*>(&code), sizeof(code));
+    pos += len;
+  }
+  return true;
+}
+
+
+/////////////
+// methods //
+/////////////
+void DicBuilder::build_morph(std::istream& fin, std::string out_stem, int thread_num, size_t chunk_bytes) {
+  static const char _ANAL_RESULT_DELIM = '\1';    // delimiter between ambiguous analysis results
+  static const char _MORPH_DELIM = '\2';    // delimiter between morphemes in single analysis result
+  _runs_t runs(out_stem, thread_num, chunk_bytes);
+  std::string line;
+  std::string utf32;
+  for (uint64_t line_num = 1; std::getline(fin, line); ++line_num) {
+    if (line_num % 1000000 == 0) BOOST_LOG_TRIVIAL(info) << (line_num / 1000000) << "m-th line";
+    _strip(&line);
+    if (line.empty()) continue;
+    auto tab_pos = line.find('\t');
+    std::string line_str = boost::lexical_cast<std::string>(line_num);
+    HANAL_ASSERT(tab_pos != std::string::npos, "No tab at line(" + line_str + ")");
+    utf32.clear();
+    HANAL_ASSERT(_to_utf32(line, &utf32), "Invalid UTF-8 at line(" + line_str + ")");
+    _entry_t entry;
+    entry.key = line.substr(0, tab_pos);
+    entry.val = line.substr(tab_pos + 1);
+    HANAL_ASSERT(entry.val.find(_ANAL_RESULT_DELIM) == std::string::npos &&
+                 entry.val.find(_MORPH_DELIM) == std::string::npos,
+                 "Delimiter in morpheme results at line(" + line_str + ")");
+    boost::replace_all(entry.val, "\t", std::string(1, _ANAL_RESULT_DELIM));
+    boost::replace_all(entry.val, " + ", std::string(1, _MORPH_DELIM));
+    entry.seq = line_num;
+    runs.add(std::move(entry));
+  }
+
+  // value is set of morphemes sorted and joined, then terminated with zero in UTF-32
+  auto sorted_path = runs.merge([] (std::vector<std::string>* vals) {
+    std::sort(vals->begin(), vals->end());
+    vals->erase(std::unique(vals->begin(), vals->end()), vals->end());
+    std::string utf32;
+    _to_utf32(boost::join(*vals, std::string(1, _ANAL_RESULT_DELIM)), &utf32);
+    utf32.append(sizeof(int32_t), '\0');
+    return utf32;
+  });
+  _write_trie(sorted_path, out_stem, true, chunk_bytes);
+  index_morph_val(out_stem);
+}
+
+
+void DicBuilder::build_state_feat(std::istream& fin, std::string out_stem, int thread_num, size_t chunk_bytes) {
+  _runs_t runs(out_stem, thread_num, chunk_bytes);
+  std::string line;
+  std::string utf32;
+  std::vector<std::string> cols;
+  bool is_in_state_feat = false;
+  for (uint64_t line_num = 1; std::getline(fin, line); ++line_num) {
+    if (line_num % 1000000 == 0) BOOST_LOG_TRIVIAL(info) << (line_num / 1000000) << "m-th line reading..";
+    _strip(&line);
+    if (!is_in_state_feat) {
+      is_in_state_feat = boost::starts_with(line, "STATE_FEATURES = {");
+      continue;
+    }
+    if (line == "}") break;
+    boost::split(cols, line, boost::is_any_of(" \t\n\r\v\f"), boost::token_compress_on);
+    if (cols.size() != 5 || !boost::ends_with(cols[3], ":")) {
+      BOOST_LOG_TRIVIAL(error) << (cols.size() != 5 ? "Invalid column number:" + std::to_string(cols.size()) :
+                                   "Colon not found at the end of state")
+                               << " at line(" << line_num << "): " << line;
+      continue;
+    }
+    std::string line_str = boost::lexical_cast<std::string>(line_num);
+    std::string tag = cols[3].substr(0, cols[3].length() - 1);
+    auto sejong = Util::to_sejong(std::wstring(tag.begin(), tag.end()).c_str());
+    char* end = nullptr;
+    double weight = strtod(cols[4].c_str(), &end);
+    HANAL_ASSERT(end != cols[4].c_str() && *end == '\0', "Invalid weight at line(" + line_str + "): " + cols[4]);
+    _entry_t entry;
+    entry.key = static_cast<char>('A' + static_cast<int>(sejong)) + cols[1];
+    utf32.clear();
+    HANAL_ASSERT(_to_utf32(entry.key, &utf32), "Invalid UTF-8 at line(" + line_str + ")");
+    if (weight != 0.0) {    // zero is none. checked before narrowing as make_state_feat_dic.py does
+      auto weight_f = static_cast<float>(weight);
+      entry.val.assign(reinterpret_cast<const char*>(&weight_f), sizeof(weight_f));
+    }
+    entry.seq = line_num;
+    runs.add(std::move(entry));
+  }
+
+  // the last one wins among same features
+  auto sorted_path = runs.merge([] (std::vector<std::string>* vals) { return vals->back(); });
+  _write_trie(sorted_path, out_stem, false, chunk_bytes);
+}
+
+
+void DicBuilder::layout_morph(std::string stem, std::istream& profile) {
+  auto nodes = _read<_trie_node_t>(stem + ".trie");
+  auto vals = _read<int32_t>(stem + ".val");
+  auto lens = _read<int16_t>(stem + ".val.len");
+  HANAL_ASSERT(!nodes.empty() && nodes[0].ch == 0, "Invalid trie file: " + stem + ".trie");
+  HANAL_ASSERT(vals.empty() || vals[0] != MorphDic::VAL_MAGIC, "Values are compiled already: " + stem + ".val");
+  std::vector<int> val_offsets(lens.size() + 1, 0);
+  std::vector<int> val_nodes(lens.size(), -1);    // node of each value
+  for (int idx = 0; idx < lens.size(); ++idx) val_offsets[idx + 1] = val_offsets[idx] + lens[idx];
+  HANAL_ASSERT(val_offsets.back() == vals.size(), "Invalid value files: " + stem);
+  for (int idx = 0; idx < nodes.size(); ++idx) {
+    if (nodes[idx].val_idx < 0) continue;
+    HANAL_ASSERT(nodes[idx].val_idx < lens.size(), "Invalid value index at node: " + std::to_string(idx));
+    val_nodes[nodes[idx].val_idx] = idx;
+  }
+
+  // count visits of nodes and values while searching common prefixes from every character of words
+  std::vector<uint64_t> node_hits(nodes.size(), 0);
+  std::vector<uint64_t> val_hits(lens.size(), 0);
+  std::string line;
+  std::vector<std::string> words;
+  std::string utf32;
+  for (uint64_t line_num = 1; std::getline(profile, line); ++line_num) {
+    auto tab_pos = line.find('\t');
+    uint64_t freq = 1;
+    if (tab_pos != std::string::npos) {
+      std::string freq_str = line.substr(tab_pos + 1);
+      _strip(&freq_str);
+      try {
+        freq = boost::lexical_cast<uint64_t>(freq_str);
+      } catch (boost::bad_lexical_cast&) {
+        HANAL_THROW("Invalid frequency at line(" + std::to_string(line_num) + "): " + freq_str);
+      }
+      line.erase(tab_pos);
+    }
+    _strip(&line);
+    if (line.empty()) continue;
+    boost::split(words, line, boost::is_any_of(" \t\n\r\v\f"), boost::token_compress_on);
+    for (auto& word : words) {
+      utf32.clear();
+      if (!_to_utf32(word, &utf32)) continue;
+      auto chars = reinterpret_cast<const int32_t*>(utf32.data());
+      int len = utf32.size() / sizeof(int32_t);
+      for (int start = 0; start < len; ++start) {
+        int node = 0;
+        node_hits[node] += freq;
+        for (int idx = start; idx < len && nodes[node].child_start > 0 && nodes[node].child_num > 0; ++idx) {
+          auto begin = nodes.begin() + node + nodes[node].child_start;
+          auto end = begin + nodes[node].child_num;
+          auto found = std::lower_bound(begin, end, chars[idx],
+                                        [] (const _trie_node_t& child, int32_t ch) { return child.ch < ch; });
+          if (found == end || found->ch != chars[idx]) break;
+          node = found - nodes.begin();
+          node_hits[node] += freq;
+          if (nodes[node].val_idx >= 0) val_hits[nodes[node].val_idx] += freq;
+        }
+      }
+    }
+  }
+
+  // children of a node are placed in order of visits of the node. since a node is visited at least as many as its
+  // children (and the former in breadth first order wins a tie), children always come after their parent
+  std::vector<int> parents;
+  for (int idx = 0; idx < nodes.size(); ++idx) {
+    if (nodes[idx].child_start > 0 && nodes[idx].child_num > 0) parents.emplace_back(idx);
+  }
+  std::stable_sort(parents.begin(), parents.end(),
+                   [&node_hits] (int lhs, int rhs) { return node_hits[lhs] > node_hits[rhs]; });
+  std::vector<int> new_pos(nodes.size(), 0);    // root stays at 0
+  int pos = 1;
+  for (int parent : parents) {
+    for (int idx = 0; idx < nodes[parent].child_num; ++idx) new_pos[parent + nodes[parent].child_start + idx] = pos++;
+  }
+  HANAL_ASSERT(pos == nodes.size(), "Invalid trie file (not a tree): " + stem + ".trie");
+  std::vector<int> val_order(lens.size());    // old value indices in new order
+  for (int idx = 0; idx < val_order.size(); ++idx) val_order[idx] = idx;
+  std::sort(val_order.begin(), val_order.end(), [&] (int lhs, int rhs) {
+    if (val_hits[lhs] != val_hits[rhs]) return val_hits[lhs] > val_hits[rhs];
+    return new_pos[val_nodes[lhs]] < new_pos[val_nodes[rhs]];
+  });
+  std::vector<int> new_val_idx(lens.size());
+  for (int idx = 0; idx < val_order.size(); ++idx) new_val_idx[val_order[idx]] = idx;
+
+  std::vector<_trie_node_t> new_nodes(nodes.size());
+  for (int idx = 0; idx < nodes.size(); ++idx) {
+    _trie_node_t& node = new_nodes[new_pos[idx]];
+    node = nodes[idx];
+    if (node.val_idx >= 0) node.val_idx = new_val_idx[node.val_idx];
+    if (node.child_start > 0 && node.child_num > 0) node.child_start = new_pos[idx + node.child_start] - new_pos[idx];
+  }
+  std::vector<int32_t> new_vals;
+  std::vector<int16_t> new_lens;
+  new_vals.reserve(vals.size());
+  new_lens.reserve(lens.size());
+  for (int old_idx : val_order) {
+    new_vals.insert(new_vals.end(), vals.begin() + val_offsets[old_idx], vals.begin() + val_offsets[old_idx + 1]);
+    new_lens.emplace_back(lens[old_idx]);
+  }
+  _write(stem + ".trie", new_nodes);
+  _write(stem + ".val", new_vals);
+  _write(stem + ".val.len", new_lens);
+  index_morph_val(stem);
+  BOOST_LOG_TRIVIAL(info) << "Hot nodes: " << std::count_if(node_hits.begin(), node_hits.end(),
+                                                              [] (uint64_t hits) { return hits > 0; })
+                          << " / " << nodes.size();
+  BOOST_LOG_TRIVIAL(info) << "Hot values: " << std::count_if(val_hits.begin(), val_hits.end(),
+                                                               [] (uint64_t hits) { return hits > 0; })
+                          << " / " << lens.size();
+}
+
+
+void DicBuilder::compile_morph_val(std::string stem) {
+  auto vals = _read<wchar_t>(stem + ".val");
+  auto lens = _read<int16_t>(stem + ".val.len");
+  HANAL_ASSERT(vals.empty() || vals[0] != MorphDic::VAL_MAGIC, "Values are compiled already: " + stem + ".val");
+  std::vector<_val_rec_t> val_recs(lens.size());
+  std::vector<_anal_rec_t> anal_recs;
+  std::vector<_morph_rec_t> morph_recs;
+  std::vector<wchar_t> lexes;
+  std::unordered_map<std::wstring, uint32_t> lex_starts;    // lexical forms are stored once
+  size_t offset = 0;
+  for (int idx = 0; idx < lens.size(); ++idx) {
+    HANAL_ASSERT(lens[idx] > 0 && offset + lens[idx] <= vals.size() && vals[offset + lens[idx] - 1] == L'\0',
+                 "Invalid value files at value: " + std::to_string(idx));
+    std::wstring val(&vals[offset]);
+    offset += lens[idx];
+    val_recs[idx].anal_start = anal_recs.size();
+    std::vector<std::wstring> anal_strs;
+    boost::split(anal_strs, val, boost::is_any_of(L"\1"));
+    for (auto& anal_str : anal_strs) {
+      _anal_rec_t anal_rec;
+      anal_rec.morph_start = morph_recs.size();
+      std::vector<std::wstring> morph_strs;
+      boost::split(morph_strs, anal_str, boost::is_any_of(L"\2"));
+      for (auto& morph_str : morph_strs) {
+        auto slash_pos = morph_str.rfind(L'/');    // same to MorphDic::_parse_text()
+        HANAL_ASSERT(slash_pos != std::wstring::npos, "Invalid morpheme format: " + Util::to_utf8(morph_str));
+        std::wstring lex = morph_str.substr(0, slash_pos);
+        HANAL_ASSERT(lex.length() <= 0xFFFF, "Too long lexical form: " + Util::to_utf8(lex));
+        auto inserted = lex_starts.emplace(lex, lexes.size());
+        if (inserted.second) {
+          lexes.insert(lexes.end(), lex.begin(), lex.end());
+          lexes.emplace_back(L'\0');
+        }
+        _morph_rec_t morph_rec;
+        morph_rec.lex_start = inserted.first->second;
+        morph_rec.lex_len = lex.length();
+        morph_rec.tag = static_cast<uint8_t>(Util::to_sejong(morph_str.c_str() + slash_pos + 1));
+        morph_recs.emplace_back(morph_rec);
+      }
+      anal_rec.morph_num = morph_recs.size() - anal_rec.morph_start;
+      anal_recs.emplace_back(anal_rec);
+    }
+    val_recs[idx].anal_num = anal_recs.size() - val_recs[idx].anal_start;
+  }
+  HANAL_ASSERT(offset == vals.size(), "Invalid value files: " + stem);
+
+  _morph_val_header_t header;
+  header.magic = MorphDic::VAL_MAGIC;
+  header.val_num = val_recs.size();
+  header.anal_num = anal_recs.size();
+  header.morph_num = morph_recs.size();
+  header.lex_size = lexes.size();
+  std::ofstream fout(stem + ".val", std::ios::binary);
+  HANAL_ASSERT(fout.good(), "Fail to open file: " + stem + ".val");
+  fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  fout.write(reinterpret_cast<const char*>(val_recs.data()), val_recs.size() * sizeof(_val_rec_t));
+  fout.write(reinterpret_cast<const char*>(anal_recs.data()), anal_recs.size() * sizeof(_anal_rec_t));
+  fout.write(reinterpret_cast<const char*>(morph_recs.data()), morph_recs.size() * sizeof(_morph_rec_t));
+  fout.write(reinterpret_cast<const char*>(lexes.data()), lexes.size() * sizeof(wchar_t));
+  HANAL_ASSERT(fout.good(), "Fail to write file: " + stem + ".val");
+  std::remove((stem + ".val.off").c_str());
+  BOOST_LOG_TRIVIAL(info) << "Compiled values: " << val_recs.size() << " values, " << anal_recs.size()
+                          << " analysis results, " << morph_recs.size() << " morphemes, " << lex_starts.size()
+                          << " lexical forms";
+}
+
+
+void DicBuilder::index_morph_val(std::string stem) {
+  auto lens = _read<int16_t>(stem + ".val.len");
+  std::vector<int32_t> offsets(lens.size() + 1, 0);
+  for (int idx = 0; idx < lens.size(); ++idx) {
+    HANAL_ASSERT(lens[idx] > 0 && offsets[idx] <= INT32_MAX - lens[idx],
+                 "Invalid value length at value: " + std::to_string(idx));
+    offsets[idx + 1] = offsets[idx] + lens[idx];
+  }
+  _val_off_header_t header;
+  header.magic = MorphDic::VAL_OFF_MAGIC;
+  header.val_num = lens.size();
+  header.val_size = offsets.back();
+  std::ofstream fout(stem + ".val.off", std::ios::binary);
+  HANAL_ASSERT(fout.good(), "Fail to open file: " + stem + ".val.off");
+  fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  fout.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(int32_t));
+}
+
+
+bool DicBuilder::_entry_t::operator<(const _entry_t& that) const {
+  int cmp = key.compare(that.key);
+  return cmp < 0 || (cmp == 0 && seq < that.seq);
+}
+
+
+DicBuilder::_runs_t::_runs_t(std::string out_stem, int thread_num, size_t chunk_bytes)
+    : _out_stem(out_stem), _thread_num(std::max(thread_num, 1)), _chunk_bytes(chunk_bytes) {}
+
+
+DicBuilder::_runs_t::~_runs_t() {
+  for (auto& path : _paths) std::remove(path.c_str());
+}
+
+
+void DicBuilder::_runs_t::add(_entry_t&& entry) {
+  _bytes += sizeof(entry) + entry.key.size() + entry.val.size();
+  _entries.emplace_back(std::move(entry));
+  if (_bytes >= _chunk_bytes) _flush();
+}
+
+
+std::string DicBuilder::_runs_t::merge(_reducer_t reducer) {
+  if (!_entries.empty() || _paths.empty()) _flush();
+  BOOST_LOG_TRIVIAL(info) << "Merging " << _paths.size() << " run(s)..";
+  std::vector<std::ifstream> fins;
+  for (auto& path : _paths) {
+    fins.emplace_back(path, std::ios::binary);
+    HANAL_ASSERT(fins.back().good(), "Fail to open file: " + path);
+  }
+  auto read_entry = [&fins] (int run, _entry_t* entry) {
+    if (!_read_str(fins[run], &entry->key)) return false;
+    _read_str(fins[run], &entry->val);
+    fins[run].read(reinterpret_cast<char*>(&entry->seq), sizeof(entry->seq));
+    return true;
+  };
+  auto greater = [] (const std::pair<_entry_t, int>& lhs, const std::pair<_entry_t, int>& rhs) {
+    return rhs.first < lhs.first;
+  };
+  std::priority_queue<std::pair<_entry_t, int>, std::vector<std::pair<_entry_t, int>>, decltype(greater)>
+      heap(greater);
+  for (int run = 0; run < fins.size(); ++run) {
+    _entry_t entry;
+    if (read_entry(run, &entry)) heap.emplace(std::move(entry), run);
+  }
+
+  std::string sorted_path = _out_stem + ".sorted";
+  _paths.emplace_back(sorted_path);
+  std::ofstream fout(sorted_path, std::ios::binary);
+  HANAL_ASSERT(fout.good(), "Fail to open file: " + sorted_path);
+  std::string key;
+  std::vector<std::string> vals;
+  auto write_key = [&] () {
+    std::string utf32;
+    _to_utf32(key, &utf32);
+    _write_str(fout, utf32);
+    _write_str(fout, reducer(&vals));
+  };
+  while (!heap.empty()) {
+    auto top = heap.top();
+    heap.pop();
+    if (!vals.empty() && top.first.key != key) {
+      write_key();
+      vals.clear();
+    }
+    key.swap(top.first.key);
+    vals.emplace_back(std::move(top.first.val));
+    if (read_entry(top.second, &top.first)) heap.emplace(std::move(top.first), top.second);
+  }
+  if (!vals.empty()) write_key();
+  HANAL_ASSERT(fout.good(), "Fail to write file: " + sorted_path);
+  return sorted_path;
+}
+
+
+void DicBuilder::_runs_t::_flush() {
+  _sort(&_entries, _thread_num);
+  std::string path = _out_stem + ".run." + std::to_string(_paths.size());
+  _paths.emplace_back(path);
+  std::ofstream fout(path, std::ios::binary);
+  HANAL_ASSERT(fout.good(), "Fail to open file: " + path);
+  for (auto& entry : _entries) {
+    _write_str(fout, entry.key);
+    _write_str(fout, entry.val);
+    fout.write(reinterpret_cast<const char*>(&entry.seq), sizeof(entry.seq));
+  }
+  HANAL_ASSERT(fout.good(), "Fail to write file: " + path);
+  BOOST_LOG_TRIVIAL(info) << path << ": " << _entries.size() << " entries";
+  _entries.clear();
+  _bytes = 0;
+}
+
+
+void DicBuilder::_write_trie(std::string sorted_path, std::string out_stem, bool with_len, size_t chunk_bytes) {
+  // nodes of depth d are distinct prefixes of length d in sorted order, which is breadth first order of trie.py.
+  // first pass counts nodes and values of each depth
+  std::vector<int> node_nums(1, 1);    // root
+  std::vector<int> val_nums(1, 0);
+  std::vector<size_t> val_bytes(1, 0);
+  auto each_key = [&sorted_path] (std::function<void(const int32_t* key, int len, int lcp, const std::string& val)>
+                                  func) {
+    std::ifstream fin(sorted_path, std::ios::binary);
+    HANAL_ASSERT(fin.good(), "Fail to open file: " + sorted_path);
+    std::string prev;
+    std::string key;
+    std::string val;
+    while (_read_str(fin, &key)) {
+      _read_str(fin, &val);
+      HANAL_ASSERT(!key.empty(), "Empty key");
+      int lcp = 0;    // longest common prefix with previous key
+      int len = key.size() / sizeof(int32_t);
+      auto chars = reinterpret_cast<const int32_t*>(key.data());
+      auto prev_chars = reinterpret_cast<const int32_t*>(prev.data());
+      int prev_len = prev.size() / sizeof(int32_t);
+      while (lcp < len && lcp < prev_len && chars[lcp] == prev_chars[lcp]) ++lcp;
+      func(chars, len, lcp, val);
+      prev.swap(key);
+    }
+  };
+  each_key([&] (const int32_t* /*key*/, int len, int lcp, const std::string& val) {
+    if (node_nums.size() <= len) {
+      node_nums.resize(len + 1, 0);
+      val_nums.resize(len + 1, 0);
+      val_bytes.resize(len + 1, 0);
+    }
+    for (int depth = lcp + 1; depth <= len; ++depth) node_nums[depth] += 1;
+    if (val.empty()) return;
+    val_nums[len] += 1;
+    val_bytes[len] += val.size();
+  });
+  int depth_num = node_nums.size();
+  std::vector<int> node_starts(depth_num + 1, 0);    // index of first node of each depth
+  std::vector<int> val_starts(depth_num + 1, 0);    // index of first value of each depth
+  for (int depth = 0; depth < depth_num; ++depth) {
+    node_starts[depth + 1] = node_starts[depth] + node_nums[depth];
+    val_starts[depth + 1] = val_starts[depth] + val_nums[depth];
+  }
+
+  std::ofstream fout_key(out_stem + ".trie", std::ios::binary);
+  std::ofstream fout_val(out_stem + ".val", std::ios::binary);
+  std::ofstream fout_len;
+  if (with_len) fout_len.open(out_stem + ".val.len", std::ios::binary);
+  HANAL_ASSERT(fout_key.good() && fout_val.good() && (!with_len || fout_len.good()),
+               "Fail to open output files: " + out_stem);
+
+  // following passes build nodes of as many depths as the memory budget allows at a time
+  struct level_t {
+    std::vector<_trie_node_t> nodes;    // nodes of the depth
+    std::string vals;    // values of nodes
+    std::vector<int16_t> lens;    // lengths of values in UTF-32
+    int val_serial = 0;    // next value index
+    int child_pos = 0;    // index of next child node
+  };
+  for (int low = 0; low < depth_num; ) {
+    int high = low + 1;
+    size_t bytes = node_nums[low] * sizeof(_trie_node_t) + val_bytes[low];
+    while (high < depth_num && bytes + node_nums[high] * sizeof(_trie_node_t) + val_bytes[high] <= chunk_bytes) {
+      bytes += node_nums[high] * sizeof(_trie_node_t) + val_bytes[high];
+      high += 1;
+    }
+    std::vector<level_t> levels(high - low);
+    for (int depth = low; depth < high; ++depth) {
+      levels[depth - low].nodes.reserve(node_nums[depth]);
+      levels[depth - low].val_serial = val_starts[depth];
+      levels[depth - low].child_pos = node_starts[depth + 1];
+    }
+    auto new_node = [] (level_t* level, wchar_t ch) {
+      _trie_node_t node;
+      node.ch = ch;
+      node.child_num = 0;
+      level->nodes.emplace_back(node);
+    };
+    if (low == 0) new_node(&levels[0], 0);    // root
+    each_key([&] (const int32_t* key, int len, int lcp, const std::string& val) {
+      for (int depth = std::max(low, lcp + 1); depth < high && depth <= len; ++depth) {
+        level_t& level = levels[depth - low];
+        new_node(&level, key[depth - 1]);
+        if (depth < len || val.empty()) continue;
+        level.nodes.back().val_idx = level.val_serial++;
+        level.vals += val;
+        if (!with_len) continue;
+        int utf32_len = val.size() / sizeof(int32_t);    // length includes terminating zero
+        HANAL_ASSERT(utf32_len <= 32767, "Too long value: " + std::to_string(utf32_len));
+        level.lens.emplace_back(utf32_len);
+      }
+      for (int depth = std::max(low, lcp); depth < high && depth < len; ++depth) {
+        level_t& level = levels[depth - low];
+        _trie_node_t& node = level.nodes.back();
+        int node_idx = node_starts[depth] + static_cast<int>(level.nodes.size()) - 1;
+        if (node.child_num == 0) node.child_start = level.child_pos - node_idx;
+        node.child_num += 1;
+        level.child_pos += 1;
+      }
+    });
+    for (auto& level : levels) {
+      fout_key.write(reinterpret_cast<const char*>(level.nodes.data()), level.nodes.size() * sizeof(_trie_node_t));
+      fout_val.write(level.vals.data(), level.vals.size());
+      if (with_len) fout_len.write(reinterpret_cast<const char*>(level.lens.data()), level.lens.size() * 2);
+    }
+    low = high;
+  }
+  HANAL_ASSERT(fout_key.good() && fout_val.good() && (!with_len || fout_len.good()),
+               "Fail to write output files: " + out_stem);
+  BOOST_LOG_TRIVIAL(info) << "Number of nodes: " << node_starts[depth_num];
+  BOOST_LOG_TRIVIAL(info) << "Number of values: " << val_starts[depth_num];
+}
+
+
+void DicBuilder::_sort(std::vector<_entry_t>* entries, int thread_num) {
+  if (thread_num <= 1 || entries->size() < thread_num * 2) {
+    std::sort(entries->begin(), entries->end());
+    return;
+  }
+
+  // sort partitions in parallel and merge neighboring ones in parallel until a single one remains
+  std::vector<size_t> bounds;
+  for (int part = 0; part <= thread_num; ++part) bounds.emplace_back(entries->size() * part / thread_num);
+  auto begin = entries->begin();
+  std::vector<std::thread> threads;
+  for (int part = 0; part < thread_num; ++part) {
+    threads.emplace_back([&, part] () { std::sort(begin + bounds[part], begin + bounds[part + 1]); });
+  }
+  for (auto& thread : threads) thread.join();
+  for (int step = 1; step < thread_num; step *= 2) {
+    threads.clear();
+    for (int part = 0; part + step < thread_num; part += step * 2) {
+      threads.emplace_back([&, part, step] () {
+        std::inplace_merge(begin + bounds[part], begin + bounds[part + step],
+                           begin + bounds[std::min(part + step * 2, thread_num)]);
+      });
+    }
+    for (auto& thread : threads) thread.join();
+  }
+}
+
+
+template<typename T>
+std::vector<T> DicBuilder::_read(std::string path) {
+  std::ifstream fin(path, std::ios::binary | std::ios::ate);
+  HANAL_ASSERT(fin.good(), "Fail to open file: " + path);
+  size_t size = fin.tellg();
+  HANAL_ASSERT(size % sizeof(T) == 0, "Invalid size of file: " + path);
+  std::vector<T> data(size / sizeof(T));
+  fin.seekg(0);
+  fin.read(reinterpret_cast<char*>(data.data()), size);
+  HANAL_ASSERT(fin.good(), "Fail to read file: " + path);
+  return data;
+}
+
+
+template<typename T>
+void DicBuilder::_write(std::string path, const std::vector<T>& data) {
+  std::ofstream fout(path, std::ios::binary);
+  HANAL_ASSERT(fout.good(), "Fail to open file: " + path);
+  fout.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+  HANAL_ASSERT(fout.good(), "Fail to write file: " + path);
+}
+
+
+void DicBuilder::_strip(std::string* line) {
+  static const char* _SPACES = " \t\n\r\v\f";
+  auto end = line->find_last_not_of(_SPACES);
+  if (end == std::string::npos) {
+    line->clear();
+    return;
+  }
+  line->erase(end + 1);
+  line->erase(0, line->find_first_not_of(_SPACES));
+}
+
+
+}    // namespace hanal
@@ -0,0 +1,168 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#ifndef HANAL_DICBUILDER_HPP
+#define HANAL_DICBUILDER_HPP
+
+
+//////////////
+// includes //
+//////////////
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <string>
+#include <vector>
+
+
+namespace hanal {
+
+
+/**
+ * dictionary compiler which writes the same files to make_syll_morph_dic.py and make_state_feat_dic.py. entries are
+ * sorted in runs of bounded memory which are merged afterwards, and trie nodes are written level by level, so memory
+ * usage is bounded by chunk size regardless of input size
+ */
+class DicBuilder {
+ public:
+  static const size_t DEFAULT_CHUNK_BYTES = 256 * 1024 * 1024;    ///< default memory budget of a chunk
+
+  /**
+   * @brief               build syllable-morpheme dictionary (.trie, .val, .val.len and .val.off) from TSV lines
+   * @param  fin          input stream of "syllables<TAB>morphemes" lines
+   * @param  out_stem     output file name without extension
+   * @param  thread_num   number of threads to sort
+   * @param  chunk_bytes  memory budget of entries sorted at a time and of nodes built at a time
+   */
+  static void build_morph(std::istream& fin, std::string out_stem, int thread_num = 1,
+                          size_t chunk_bytes = DEFAULT_CHUNK_BYTES);
+
+  /**
+   * @brief               build state-features dictionary (.trie and .val) from dump of crfsuite model
+   * @param  fin          input stream of "crfsuite dump" output
+   * @param  out_stem     output file name without extension
+   * @param  thread_num   number of threads to sort
+   * @param  chunk_bytes  memory budget of entries sorted at a time and of nodes built at a time
+   */
+  static void build_state_feat(std::istream& fin, std::string out_stem, int thread_num = 1,
+                               size_t chunk_bytes = DEFAULT_CHUNK_BYTES);
+
+  /**
+   * @brief           lay out syllable-morpheme dictionary files for cache locality with frequency profile. children
+   *                  of frequently visited nodes come first (still after their parents) and values are numbered in
+   *                  order of frequency, so hot nodes and hot values share contiguous pages. files are rewritten
+   *                  in the same format, but values are no longer numbered in breadth first order
+   * @param  stem     stem of dictionary files (.trie, .val, .val.len and .val.off)
+   * @param  profile  input stream of "text[<TAB>frequency]" lines. every word in text is searched from each of its
+   *                  characters as the analyzer does. frequency is 1 if omitted
+   */
+  static void layout_morph(std::string stem, std::istream& profile);
+
+  /**
+   * @brief        compile text values of syllable-morpheme dictionary (.val and .val.len) into binary .val which is
+   *               used in place without parsing (see _morph_val_header_t). value indices are kept and .val.off is
+   *               removed since records have their own offsets
+   * @param  stem  stem of dictionary files
+   */
+  static void compile_morph_val(std::string stem);
+
+  /**
+   * @brief        write offsets of text values (.val.off) from their lengths (.val.len), so that MorphDic opens
+   *               dictionary without summing lengths. the file has header (see _val_off_header_t), then start offset
+   *               (in characters) of each value and the total length at the end in int32
+   * @param  stem  stem of dictionary files
+   */
+  static void index_morph_val(std::string stem);
+
+ private:
+  struct _entry_t {    ///< key-value entry of input
+    std::string key;    ///< key in UTF-8 (order of bytes is same to order of code points)
+    std::string val;    ///< value
+    uint64_t seq = 0;    ///< sequence number in input (line number)
+    bool operator<(const _entry_t& that) const;    ///< order by key and sequence
+  };
+
+  /**
+   * @brief        reduce values of same key into final value in binary. empty for no value
+   * @param  vals  values in input order
+   */
+  typedef std::function<std::string(std::vector<std::string>* vals)> _reducer_t;
+
+  /**
+   * collector of entries which writes sorted runs into temporary files whenever chunk is full
+   */
+  class _runs_t {
+   public:
+    /**
+     * @brief               ctor
+     * @param  out_stem     output file name without extension (prefix of temporary files)
+     * @param  thread_num   number of threads to sort
+     * @param  chunk_bytes  memory budget of a chunk
+     */
+    _runs_t(std::string out_stem, int thread_num, size_t chunk_bytes);
+
+    virtual ~_runs_t();    ///< dtor. remove temporary files
+
+    void add(_entry_t&& entry);    ///< add entry
+
+    /**
+     * @brief           merge runs, reduce values of each key and write sorted file of (key in UTF-32, value)
+     * @param  reducer  reducer of values
+     * @return          path of sorted file
+     */
+    std::string merge(_reducer_t reducer);
+
+   private:
+    std::string _out_stem;    ///< prefix of temporary files
+    int _thread_num = 1;    ///< number of threads to sort
+    size_t _chunk_bytes = 0;    ///< memory budget of a chunk
+    std::vector<_entry_t> _entries;    ///< entries of current chunk
+    size_t _bytes = 0;    ///< bytes of current chunk
+    std::vector<std::string> _paths;    ///< paths of temporary files
+
+    void _flush();    ///< sort current chunk and write it into run file
+  };
+
+  /**
+   * @brief               write trie (and values) from sorted file in the same layout to trie.py
+   * @param  sorted_path  sorted file written by _runs_t::merge()
+   * @param  out_stem     output file name without extension
+   * @param  with_len     whether to write .val.len file (values are in UTF-32)
+   * @param  chunk_bytes  memory budget of nodes and values built at a time
+   */
+  static void _write_trie(std::string sorted_path, std::string out_stem, bool with_len, size_t chunk_bytes);
+
+  /**
+   * @brief               sort entries with multiple threads
+   * @param  entries      entries
+   * @param  thread_num   number of threads
+   */
+  static void _sort(std::vector<_entry_t>* entries, int thread_num);
+
+  /**
+   * @brief        read whole binary file
+   * @param  path  file path
+   * @return       elements of file
+   */
+  template<typename T>
+  static std::vector<T> _read(std::string path);
+
+  /**
+   * @brief        write whole binary file
+   * @param  path  file path
+   * @param  data  elements to write
+   */
+  template<typename T>
+  static void _write(std::string path, const std::vector<T>& data);
+
+  static void _strip(std::string* line);    ///< strip white spaces at both end (same to str.strip() of Python)
+};
+
+
+}    // namespace hanal
+
+
+#endif  // HANAL_DICBUILDER_HPP
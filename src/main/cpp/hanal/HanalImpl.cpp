@@ -10,12 +10,16 @@
 //////////////
 // includes //
 //////////////
+#include <sstream>
 #include <string>
+#include <vector>
 
+#include "hanal/CharBuffer.hpp"
 #include "hanal/Except.hpp"
 #include "hanal/macro.hpp"
 #include "hanal/MorphDic.hpp"
 #include "hanal/Option.hpp"
+#include "hanal/SentSplitter.hpp"
 #include "hanal/StateFeatDic.hpp"
 #include "hanal/TransMat.hpp"
 #include "hanal/ViterbiTrellis.hpp"
@@ -49,9 +53,9 @@ SHDPTR(HanalApi) HanalApi::create() {
 void HanalImpl::open(std::string rsc_dir, std::string opt_str) {
   std::unique_lock<std::recursive_mutex> lock(_mutex);
   _option = std::make_shared<Option>(opt_str);
-  _morph_dic->open(rsc_dir);
-  _state_feat_dic->open(rsc_dir);
-  _trans_mat->open(rsc_dir + "/trans_mat.bin");
+  _morph_dic->open(rsc_dir, _option->aho_corasick, _option->residency, _option->val_cache);
+  _state_feat_dic->open(rsc_dir, _option->residency);
+  _trans_mat->open(rsc_dir + "/trans_mat.bin", false, _option->residency);
 }
 
 
@@ -64,19 +68,90 @@ void HanalImpl::close() {
 
 
 const std::string& HanalImpl::pos_tag(const char* sent, const char* opt_str) {
+  CharBuffer chars;
+  chars.characterize(sent);
+  return _pos_tag(chars, opt_str);
+}
+
+
+const std::string& HanalImpl::pos_tag(const char* sent, size_t len, const char* opt_str) {
+  CharBuffer chars;
+  chars.characterize(sent, len);
+  return _pos_tag(chars, opt_str);
+}
+
+
+const std::string& HanalImpl::pos_tag(const char16_t* sent, const char* opt_str) {
+  CharBuffer chars;
+  chars.characterize(sent);
+  return _pos_tag(chars, opt_str);
+}
+
+
+const std::string& HanalImpl::pos_tag(const char32_t* sent, const char* opt_str) {
+  CharBuffer chars;
+  chars.characterize(sent);
+  return _pos_tag(chars, opt_str);
+}
+
+
+const std::string& HanalImpl::pos_tag_doc(const char* doc, const char* opt_str) {
+  CharBuffer chars;
+  chars.characterize(doc);
+  return _pos_tag_doc(chars, opt_str);
+}
+
+
+const std::string& HanalImpl::pos_tag_doc(const char* doc, size_t len, const char* opt_str) {
+  CharBuffer chars;
+  chars.characterize(doc, len);
+  return _pos_tag_doc(chars, opt_str);
+}
+
+
+const std::string& HanalImpl::_pos_tag_doc(const CharBuffer& chars, const char* opt_str) {
   std::unique_lock<std::recursive_mutex> lock(_mutex);
   Option runtime_opt = _option->override(opt_str);
-  auto words = Word::tokenize(sent);
-  ViterbiTrellis trellis(words);
-  for (int idx = 0; idx < words.size(); ++idx) {
-    auto merged_word = *words[idx];
-    for (int merge_num = 1; merge_num < runtime_opt.word_merge; ++merge_num) {
-      merged_word += *words[idx + merge_num];
+  auto words = Word::tokenize(chars);
+  std::ostringstream oss;
+  SentSplitter splitter(chars);
+  SentSplitter::sent_t sent;
+  int word_idx = 0;
+  while (splitter.next(&sent)) {
+    // sentences end at word boundaries
+    int word_end = word_idx;
+    while (word_end < words.size() && words[word_end].char_idx < sent.char_end) word_end += 1;
+    oss << "[SENT] (" << sent.begin << ", " << sent.end << ") chars (" << sent.cp_begin << ", " << sent.cp_end << ")"
+        << std::endl;
+    oss << _tag_words(chars, words, word_idx, word_end, runtime_opt);
+    word_idx = word_end;
+  }
+  return _cache(oss.str());
+}
+
+
+const std::string& HanalImpl::_pos_tag(const CharBuffer& chars, const char* opt_str) {
+  std::unique_lock<std::recursive_mutex> lock(_mutex);
+  Option runtime_opt = _option->override(opt_str);
+  auto words = Word::tokenize(chars);
+  return _cache(_tag_words(chars, words, 0, words.size(), runtime_opt));
+}
+
+
+std::string HanalImpl::_tag_words(const CharBuffer& chars, const std::vector<Word>& words, int word_idx,
+                                  int word_end, const Option& runtime_opt) {
+  if (word_idx >= word_end) return "";
+  int char_idx = words[word_idx].char_idx;
+  ViterbiTrellis trellis(chars, char_idx, words[word_end - 1].char_end, _morph_dic->morph_table());
+  for (int idx = word_idx; idx < word_end; ++idx) {
+    auto merged_word = words[idx];
+    for (int merge_num = 1; merge_num < runtime_opt.word_merge && idx + merge_num < word_end; ++merge_num) {
+      merged_word += words[idx + merge_num];
     }
-    merged_word.analyze_forward(_morph_dic.get(), &trellis, merged_word.char_idx);
-    // if (runtime_opt.anal_back) merged_word.analyze_backward(_morph_dic.get(), &trellis, merged_word.char_idx);
+    merged_word.analyze_forward(chars, _morph_dic.get(), &trellis, merged_word.char_idx - char_idx);
+    // if (runtime_opt.anal_back) merged_word.analyze_backward(chars, _morph_dic.get(), &trellis, ...);
   }
-  return _cache(trellis.str());    ///< TODO(krikit): return reference to the internal string buffer
+  return trellis.str();    ///< TODO(krikit): return reference to the internal string buffer
 }
 
 
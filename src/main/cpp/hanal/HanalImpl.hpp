@@ -11,9 +11,11 @@
 //////////////
 // includes //
 //////////////
+#include <cstddef>
 #include <list>
 #include <mutex>    // NOLINT
 #include <string>
+#include <vector>
 
 #include "hanal/HanalApi.hpp"
 #include "hanal/macro.hpp"
@@ -22,10 +24,12 @@
 namespace hanal {
 
 
+class CharBuffer;
 class MorphDic;
 class Option;
 class StateFeatDic;
 class TransMat;
+class Word;
 
 
 /**
@@ -53,6 +57,48 @@ class HanalImpl: public HanalApi {
    */
   const std::string& pos_tag(const char* sent, const char* opt_str);
 
+  /**
+   * @brief           part-of-speech tagging for UTF-8 text with length (not necessarily null terminated)
+   * @param  sent     input sentence
+   * @param  len      length of sentence in bytes
+   * @param  opt_str  option string
+   * @return          tagged result
+   */
+  const std::string& pos_tag(const char* sent, size_t len, const char* opt_str);
+
+  /**
+   * @brief           part-of-speech tagging for UTF-16 text
+   * @param  sent     input sentence
+   * @param  opt_str  option string
+   * @return          tagged result
+   */
+  const std::string& pos_tag(const char16_t* sent, const char* opt_str);
+
+  /**
+   * @brief           part-of-speech tagging for UTF-32 text
+   * @param  sent     input sentence
+   * @param  opt_str  option string
+   * @return          tagged result
+   */
+  const std::string& pos_tag(const char32_t* sent, const char* opt_str);
+
+  /**
+   * @brief           split document into sentences and part-of-speech tagging for each sentence
+   * @param  doc      input document
+   * @param  opt_str  option string
+   * @return          tagged result
+   */
+  const std::string& pos_tag_doc(const char* doc, const char* opt_str);
+
+  /**
+   * @brief           split document with length (not necessarily null terminated) and tagging for each sentence
+   * @param  doc      input document
+   * @param  len      length of document in bytes
+   * @param  opt_str  option string
+   * @return          tagged result
+   */
+  const std::string& pos_tag_doc(const char* doc, size_t len, const char* opt_str);
+
  private:
   std::recursive_mutex _mutex;    ///< mutex to access API methods exclusively
   SHDPTR(Option) _option;    ///< option
@@ -63,6 +109,34 @@ class HanalImpl: public HanalApi {
   static const int _CACHE_MAX = 1000;    ///< max number of cache
   std::list<std::string> _str_buf;    ///< string buffer for caching
   const std::string& _cache(std::string str);    ///< cache string in internal buffer
+
+  /**
+   * @brief           part-of-speech tagging for characterized sentence
+   * @param  chars    characters of sentence
+   * @param  opt_str  option string
+   * @return          tagged result
+   */
+  const std::string& _pos_tag(const CharBuffer& chars, const char* opt_str);
+
+  /**
+   * @brief           split characterized document into sentences and tagging for each sentence
+   * @param  chars    characters of document
+   * @param  opt_str  option string
+   * @return          tagged result
+   */
+  const std::string& _pos_tag_doc(const CharBuffer& chars, const char* opt_str);
+
+  /**
+   * @brief               part-of-speech tagging for a range of words
+   * @param  chars        characters of text
+   * @param  words        words of text
+   * @param  word_idx     start word index
+   * @param  word_end     end word index (exclusive)
+   * @param  runtime_opt  runtime option
+   * @return              tagged result
+   */
+  std::string _tag_words(const CharBuffer& chars, const std::vector<Word>& words, int word_idx, int word_end,
+                         const Option& runtime_opt);
 };
 
 
@@ -0,0 +1,129 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#include "hanal/Jamo.hpp"
+
+
+namespace hanal {
+
+
+//////////////////
+// static members //
+//////////////////
+const int Jamo::SYLLABLE_NUM;
+constexpr wchar_t Jamo::_CHOSEONG[19];
+constexpr wchar_t Jamo::_JUNGSEONG[21];
+constexpr wchar_t Jamo::_JONGSEONG[28];
+const Jamo::_syllable_table_t Jamo::_SYLLABLE_TABLE;
+
+
+///////////////
+// functions //
+///////////////
+/**
+ * @brief         consonant features from jamo
+ * @param  split  jamo
+ * @return        bitwise OR of Jamo::Feature
+ */
+static inline uint8_t _features(const Jamo::split_t& split) {
+  uint8_t feats = 0;
+  if (split.cho != L'\0' && split.cho != L'ㅇ') feats |= Jamo::CIC;
+  if (split.jong != L'\0') feats |= Jamo::FC;
+  if (split.jong == L'ㄹ') feats |= Jamo::FC_RIEUL;
+  return feats;
+}
+
+
+////////////////////
+// ctors and dtor //
+////////////////////
+Jamo::_syllable_table_t::_syllable_table_t() {
+  static_assert(sizeof(_CHOSEONG) / sizeof(wchar_t) * sizeof(_JUNGSEONG) / sizeof(wchar_t)
+                * sizeof(_JONGSEONG) / sizeof(wchar_t) == SYLLABLE_NUM, "Invalid number of jamo");
+  for (int idx = 0; idx < SYLLABLE_NUM; ++idx) {
+    split_t& split = splits[idx];
+    split.cho = _CHOSEONG[idx / (21 * 28)];
+    split.jung = _JUNGSEONG[(idx / 28) % 21];
+    split.jong = _JONGSEONG[idx % 28];
+    feats[idx] = _features(split);
+  }
+}
+
+
+/////////////
+// methods //
+/////////////
+bool Jamo::is_syllable(wchar_t wchar) {
+  return L'가' <= wchar && wchar <= L'힣';
+}
+
+
+bool Jamo::is_jamo(wchar_t wchar) {
+  return L'ㄱ' <= wchar && wchar <= L'ㅣ';
+}
+
+
+bool Jamo::is_hangul(wchar_t wchar) {
+  return is_syllable(wchar) || is_jamo(wchar);
+}
+
+
+Jamo::split_t Jamo::split(wchar_t wchar) {
+  if (is_syllable(wchar)) return _SYLLABLE_TABLE.splits[wchar - L'가'];
+  split_t split;
+  if (L'ㄱ' <= wchar && wchar <= L'ㅎ') {
+    split.cho = wchar;
+  } else if (L'ㅏ' <= wchar && wchar <= L'ㅣ') {
+    split.jung = wchar;
+  }
+  return split;
+}
+
+
+void Jamo::split(const wchar_t* wchars, int size, split_t* splits) {
+  for (int idx = 0; idx < size; ++idx) splits[idx] = split(wchars[idx]);
+}
+
+
+int Jamo::compose(const wchar_t* wchars, int size, wchar_t* syllable) {
+  static const wchar_t _L_BASE = 0x1100, _V_BASE = 0x1161, _T_BASE = 0x11A7;
+  if (size < 2) return 0;
+  if (wchars[0] < _L_BASE || wchars[0] >= _L_BASE + 19) return 0;
+  if (wchars[1] < _V_BASE || wchars[1] >= _V_BASE + 21) return 0;
+  int jong = 0;
+  if (size > 2 && wchars[2] > _T_BASE && wchars[2] < _T_BASE + 28) jong = wchars[2] - _T_BASE;
+  *syllable = L'가' + ((wchars[0] - _L_BASE) * 21 + (wchars[1] - _V_BASE)) * 28 + jong;
+  return jong > 0 ? 3 : 2;
+}
+
+
+bool Jamo::is_conjoining(wchar_t wchar) {
+  return 0x1100 <= wchar && wchar <= 0x11FF;
+}
+
+
+wchar_t Jamo::initial(wchar_t wchar) {
+  return split(wchar).cho;
+}
+
+
+wchar_t Jamo::final(wchar_t wchar) {
+  return split(wchar).jong;
+}
+
+
+uint8_t Jamo::features(wchar_t wchar) {
+  if (is_syllable(wchar)) return _SYLLABLE_TABLE.feats[wchar - L'가'];
+  return _features(split(wchar));
+}
+
+
+void Jamo::features(const wchar_t* wchars, int size, uint8_t* feats) {
+  for (int idx = 0; idx < size; ++idx) feats[idx] = features(wchars[idx]);
+}
+
+
+}    // namespace hanal
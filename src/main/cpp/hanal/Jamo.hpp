@@ -0,0 +1,129 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#ifndef HANAL_JAMO_HPP
+#define HANAL_JAMO_HPP
+
+
+//////////////
+// includes //
+//////////////
+#include <array>
+#include <cstdint>
+
+
+namespace hanal {
+
+
+/**
+ * Hangul syllable decomposition into jamo (compatibility jamo letters, same to hangul.py) and composition.
+ * the tagger uses only is_syllable() (root jump table of Trie) for now. decomposition and consonant features are
+ * library-only: the current model has no consonant state features, so they are not wired into unknown word estimation
+ */
+class Jamo {
+ public:
+  static const int SYLLABLE_NUM = 11172;    ///< number of precomposed syllables (U+AC00 ~ U+D7A3)
+
+  struct split_t {    ///< decomposed jamo. L'\0' for absent one
+    wchar_t cho = L'\0';    ///< initial consonant (choseong)
+    wchar_t jung = L'\0';    ///< medial vowel (jungseong)
+    wchar_t jong = L'\0';    ///< final consonant (jongseong)
+  };
+
+  /**
+   * consonant features for CRF state features (same to sejong_tagged_to_crf_train.py)
+   */
+  enum Feature {
+    CIC = 0x01,    ///< initial consonant of first character except 'ㅇ' (current initial consonant)
+    FC = 0x02,    ///< final consonant of last character (PFC for next morpheme)
+    FC_RIEUL = 0x04,    ///< final consonant 'ㄹ' of last character (PFC=ㄹ for next morpheme)
+  };
+
+  static bool is_syllable(wchar_t wchar);    ///< whether is precomposed Hangul syllable or not
+  static bool is_jamo(wchar_t wchar);    ///< whether is Hangul compatibility jamo or not
+
+  /**
+   * @brief         whether is Hangul (syllable or compatibility jamo) or not. same to hangul.ishangul()
+   * @param  wchar  wide character
+   * @return        true if Hangul
+   */
+  static bool is_hangul(wchar_t wchar);
+
+  /**
+   * @brief         split Hangul character into jamo. same to hangul.split()
+   * @param  wchar  wide character
+   * @return        jamo (all L'\0' if not Hangul)
+   */
+  static split_t split(wchar_t wchar);
+
+  /**
+   * @brief          split characters in batch
+   * @param  wchars  wide characters
+   * @param  size    number of characters
+   * @param  splits  [out] jamo of characters (size must be same to wchars)
+   */
+  static void split(const wchar_t* wchars, int size, split_t* splits);
+
+  /**
+   * @brief           compose conjoining jamo (U+1100 ~ U+11FF) sequence of L+V(+T) into precomposed syllable
+   * @param  wchars   wide characters starting with leading consonant
+   * @param  size     number of characters available
+   * @param  syllable [out] composed syllable
+   * @return          number of jamo composed (2 or 3). 0 if not composable
+   */
+  static int compose(const wchar_t* wchars, int size, wchar_t* syllable);
+
+  static bool is_conjoining(wchar_t wchar);    ///< whether is conjoining jamo (U+1100 ~ U+11FF) or not
+
+  static wchar_t initial(wchar_t wchar);    ///< initial consonant. L'\0' if absent or not Hangul
+  static wchar_t final(wchar_t wchar);    ///< final consonant. L'\0' if absent or not Hangul
+
+  /**
+   * @brief         consonant features of a character as both first and last one of a morpheme
+   * @param  wchar  wide character
+   * @return        bitwise OR of Feature
+   */
+  static uint8_t features(wchar_t wchar);
+
+  /**
+   * @brief          consonant features of characters in batch
+   * @param  wchars  wide characters
+   * @param  size    number of characters
+   * @param  feats   [out] bitwise OR of Feature of each character (size must be same to wchars)
+   */
+  static void features(const wchar_t* wchars, int size, uint8_t* feats);
+
+ private:
+  static constexpr wchar_t _CHOSEONG[19] = {
+    L'ㄱ', L'ㄲ', L'ㄴ', L'ㄷ', L'ㄸ', L'ㄹ', L'ㅁ', L'ㅂ', L'ㅃ', L'ㅅ', L'ㅆ', L'ㅇ', L'ㅈ', L'ㅉ', L'ㅊ', L'ㅋ', L'ㅌ',
+    L'ㅍ', L'ㅎ'
+  };    ///< initial consonants in order of syllable composition
+  static constexpr wchar_t _JUNGSEONG[21] = {
+    L'ㅏ', L'ㅐ', L'ㅑ', L'ㅒ', L'ㅓ', L'ㅔ', L'ㅕ', L'ㅖ', L'ㅗ', L'ㅘ', L'ㅙ', L'ㅚ', L'ㅛ', L'ㅜ', L'ㅝ', L'ㅞ', L'ㅟ',
+    L'ㅠ', L'ㅡ', L'ㅢ', L'ㅣ'
+  };    ///< medial vowels in order of syllable composition
+  static constexpr wchar_t _JONGSEONG[28] = {
+    L'\0', L'ㄱ', L'ㄲ', L'ㄳ', L'ㄴ', L'ㄵ', L'ㄶ', L'ㄷ', L'ㄹ', L'ㄺ', L'ㄻ', L'ㄼ', L'ㄽ', L'ㄾ', L'ㄿ', L'ㅀ', L'ㅁ',
+    L'ㅂ', L'ㅄ', L'ㅅ', L'ㅆ', L'ㅇ', L'ㅈ', L'ㅊ', L'ㅋ', L'ㅌ', L'ㅍ', L'ㅎ'
+  };    ///< final consonants in order of syllable composition (first one is absent)
+
+  /**
+   * precomputed jamo of all syllables. each entry has wide characters of jamo
+   */
+  struct _syllable_table_t {
+    std::array<split_t, SYLLABLE_NUM> splits;    ///< jamo of syllables
+    std::array<uint8_t, SYLLABLE_NUM> feats;    ///< consonant features of syllables
+    _syllable_table_t();    ///< ctor. build table
+  };
+
+  static const _syllable_table_t _SYLLABLE_TABLE;    ///< syllable table
+};
+
+
+}    // namespace hanal
+
+
+#endif  // HANAL_JAMO_HPP
@@ -0,0 +1,91 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#include "hanal/MappedDic.hpp"
+
+
+//////////////
+// includes //
+//////////////
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include "boost/log/trivial.hpp"
+
+
+namespace hanal {
+
+
+///////////////
+// functions //
+///////////////
+/**
+ * @brief  size of memory page
+ */
+static size_t _page_size() {
+#ifndef _WIN32
+  static const size_t _PAGE_SIZE = sysconf(_SC_PAGESIZE);
+  return _PAGE_SIZE;
+#else
+  return 4096;
+#endif
+}
+
+
+/**
+ * @brief        read a byte of every page to fault them in
+ * @param  data  start of mapped memory
+ * @param  size  size of mapped memory
+ */
+static void _touch(const char* data, size_t size) {
+  size_t page_size = _page_size();
+  volatile char sink = 0;
+  for (size_t pos = 0; pos < size; pos += page_size) sink = sink + data[pos];
+}
+
+
+/////////////
+// methods //
+/////////////
+void residency_t::apply(const char* data, size_t size) const {
+#ifndef _WIN32
+  void* addr = const_cast<char*>(data);    // mapped address is page aligned
+  auto advise = [&] (bool is_set, int advice, const char* name) {
+    if (is_set && madvise(addr, size, advice) != 0) {
+      BOOST_LOG_TRIVIAL(warning) << "Fail to madvise(" << name << "): " << strerror(errno);
+    }
+  };
+  advise(random, MADV_RANDOM, "MADV_RANDOM");
+  advise(willneed, MADV_WILLNEED, "MADV_WILLNEED");
+#ifdef MADV_HUGEPAGE
+  advise(hugepage, MADV_HUGEPAGE, "MADV_HUGEPAGE");
+#else
+  if (hugepage) BOOST_LOG_TRIVIAL(warning) << "MADV_HUGEPAGE is not supported";
+#endif
+  if (populate) {
+#ifdef MADV_POPULATE_READ
+    if (madvise(addr, size, MADV_POPULATE_READ) != 0) _touch(data, size);
+#else
+    _touch(data, size);
+#endif
+  }
+  if (mlock && ::mlock(addr, size) != 0) {
+    BOOST_LOG_TRIVIAL(warning) << "Fail to mlock " << size << " bytes: " << strerror(errno);
+  }
+#else
+  if (random || willneed || hugepage || mlock) BOOST_LOG_TRIVIAL(warning) << "Residency advice is not supported";
+  if (populate) _touch(data, size);
+#endif
+}
+
+
+}    // namespace hanal
@@ -11,6 +11,7 @@
 //////////////
 // includes //
 //////////////
+#include <cstddef>
 #include <string>
 
 #include "boost/iostreams/device/mapped_file.hpp"
@@ -21,6 +22,25 @@
 namespace hanal {
 
 
+/**
+ * residency options of mapped file which trade open time against page faults of the first lookups
+ */
+struct residency_t {
+  bool populate = false;    ///< prefault all pages at open
+  bool willneed = false;    ///< advise kernel to read ahead whole file (MADV_WILLNEED)
+  bool hugepage = false;    ///< advise kernel to back with huge pages (MADV_HUGEPAGE)
+  bool random = false;    ///< advise kernel not to read ahead around faults (MADV_RANDOM)
+  bool mlock = false;    ///< lock pages in memory. warned and ignored if not permitted
+
+  /**
+   * @brief        apply options to mapped memory. every MappedDic applies them at open
+   * @param  data  start of mapped memory
+   * @param  size  size of mapped memory
+   */
+  void apply(const char* data, size_t size) const;
+};
+
+
 template<typename T>
 class MappedDic {
  public:
@@ -32,8 +52,9 @@ class MappedDic {
    * @brief              open resource file
    * @param  path        file path
    * @param  is_private  open mapped file as private mode
+   * @param  residency   residency options
    */
-  virtual void open(std::string path, bool is_private = false) {
+  virtual void open(std::string path, bool is_private = false, const residency_t& residency = residency_t()) {
     close();
     try {
       if (is_private) {
@@ -47,6 +68,7 @@ class MappedDic {
     HANAL_ASSERT(_map_file.is_open(), "Fail to open file: " + path);
     HANAL_ASSERT(_map_file.size() > 0 && (_map_file.size() % sizeof(T)) == 0,
                  "Invalid size of file: " + boost::lexical_cast<std::string>(_map_file.size()));
+    residency.apply(_map_file.const_data(), _map_file.size());
   }
 
   /**
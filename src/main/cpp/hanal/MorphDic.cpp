@@ -10,50 +10,94 @@
 //////////////
 // includes //
 //////////////
+#include <algorithm>
+#include <fstream>
 #include <list>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "boost/log/trivial.hpp"
+#include "hanal/Util.hpp"
 
 
 namespace hanal {
 
 
+////////////////////
+// ctors and dtor //
+////////////////////
 MorphDic::~MorphDic() {
   close();
 }
 
 
-void MorphDic::open(std::string rsc_dir) {
+/////////////
+// methods //
+/////////////
+void MorphDic::open(std::string rsc_dir, bool aho_corasick, const residency_t& residency,
+                    const cache_option_t& val_cache) {
   close();
-  _trie.open(rsc_dir + "/morph.trie");
-  _value.open(rsc_dir + "/morph.val", true);    // private mode open
-  auto val_data = _value.data();
-
-  MappedDic<int16_t> len;    // this contains length of each value text
-  len.open(rsc_dir + "/morph.val.len");
-  auto len_data = len.const_data();
-
-  int size = len.size();
-  _val_idx.reserve(size);
-  _val_idx.emplace_back(val_data);
-  int len_sum = len_data[0];
-  for (int i = 1; i < size; ++i) {
-    _val_idx.emplace_back(val_data + len_sum);
-    len_sum += len_data[i];    // add each length (length already includes zero termination)
+  _trie.open(rsc_dir + "/morph.trie", residency);
+  if (aho_corasick) _aho_corasick.build(_trie);
+  _value.open(rsc_dir + "/morph.val", false, residency);
+  auto header = reinterpret_cast<const _morph_val_header_t*>(_value.const_data());
+  if (_value.size() * sizeof(wchar_t) >= sizeof(_morph_val_header_t) && header->magic == VAL_MAGIC) {
+    // binary format is used in place without parsing
+    HANAL_ASSERT(header->val_num >= 0 && header->anal_num >= 0 && header->morph_num >= 0 && header->lex_size >= 0 &&
+                 sizeof(_morph_val_header_t) + header->val_num * sizeof(_val_rec_t) + header->anal_num *
+                 sizeof(_anal_rec_t) + header->morph_num * sizeof(_morph_rec_t) + header->lex_size * sizeof(wchar_t)
+                 == _value.size() * sizeof(wchar_t), "Invalid morpheme dic at resource dir: " + rsc_dir);
+    _val_num = header->val_num;
+    _val_header = header;
+    _val_recs = reinterpret_cast<const _val_rec_t*>(header + 1);
+    _anal_recs = reinterpret_cast<const _anal_rec_t*>(_val_recs + header->val_num);
+    _morph_recs = reinterpret_cast<const _morph_rec_t*>(_anal_recs + header->anal_num);
+    _lexes = reinterpret_cast<const wchar_t*>(_morph_recs + header->morph_num);
+  } else if (!_open_val_offs(rsc_dir, residency)) {
+    MappedDic<int16_t> len;    // this contains length of each value text
+    len.open(rsc_dir + "/morph.val.len");
+    auto len_data = len.const_data();
+
+    int size = len.size();
+    _val_offs_sum.reserve(size + 1);
+    _val_offs_sum.emplace_back(0);
+    for (int i = 0; i < size; ++i) {
+      _val_offs_sum.emplace_back(_val_offs_sum.back() + len_data[i]);    // length already includes zero termination
+    }
+
+    HANAL_ASSERT(_value.size() == _val_offs_sum.back(), "Invalid morpheme dic at resource dir: " + rsc_dir);
+    _val_off = _val_offs_sum.data();
+    _val_num = size;
   }
 
-  HANAL_ASSERT(_value.size() == len_sum, "Invalid morpheme dic at resource dir: " + rsc_dir);
+  _val_cache.open(_val_num, val_cache.budget);
+  for (int idx = 0; idx < std::min(val_cache.warm_up, _val_num); ++idx) value(idx);
   BOOST_LOG_TRIVIAL(info) << "Morpheme dictionary loaded";
 }
 
 
 void MorphDic::close() {
+  _aho_corasick.clear();
   _trie.close();
+  if (_val_num > 0) {
+    auto stat = _val_cache.stat();
+    BOOST_LOG_TRIVIAL(info) << "Morpheme value cache: " << stat.hits << " hits, " << stat.misses << " misses, "
+                            << stat.evictions << " evictions, " << stat.bytes << " bytes";
+  }
+  _val_cache.close();
   _value.close();
-  _val_idx.clear();
-  _val_cache.clear();
+  _val_offs.close();
+  _val_offs_sum.clear();
+  _val_off = nullptr;
+  _morph_table.clear();
+  _val_header = nullptr;
+  _val_recs = nullptr;
+  _anal_recs = nullptr;
+  _morph_recs = nullptr;
+  _lexes = nullptr;
+  _val_num = 0;
 }
 
 
@@ -62,11 +106,126 @@ std::list<Trie::match_t> MorphDic::lookup(const wchar_t* text) const {
 }
 
 
-const std::vector<SHDPTRVEC(Morph)>& MorphDic::value(int idx) {
-  HANAL_ASSERT(0 <= idx && idx < _val_idx.size(), "Invalid value index: " + boost::lexical_cast<std::string>(idx));
-  if (_val_cache.empty()) _val_cache.resize(_val_idx.size());
-  if (_val_cache[idx].empty()) _val_cache[idx] = Morph::parse_anal_result_vec(_val_idx[idx]);
-  return _val_cache[idx];
+std::list<Trie::match_t> MorphDic::lookup(const wchar_t* text, int len) const {
+  return _trie.search_common_prefix_matches(text, len);
+}
+
+
+TrieCursor MorphDic::cursor() const {
+  return _trie.cursor();
+}
+
+
+const AhoCorasick& MorphDic::aho_corasick() const {
+  return _aho_corasick;
+}
+
+
+MorphDic::value_ref_t MorphDic::value(int idx) {
+  HANAL_ASSERT(0 <= idx && idx < _val_num, "Invalid value index: " + boost::lexical_cast<std::string>(idx));
+  return _val_cache.get(idx, [this] (int idx) { return _parse(idx); });
+}
+
+
+const MorphTable& MorphDic::morph_table() const {
+  return _morph_table;
+}
+
+
+cache_stat_t MorphDic::cache_stat() const {
+  return _val_cache.stat();
+}
+
+
+bool MorphDic::_open_val_offs(std::string rsc_dir, const residency_t& residency) {
+  std::string path = rsc_dir + "/morph.val.off";
+  if (!std::ifstream(path).good()) {
+    BOOST_LOG_TRIVIAL(warning) << "morph.val.off not found. offsets are summed from morph.val.len";
+    return false;
+  }
+  // offsets are mapped, so open time is independent of number of values
+  _val_offs.open(path, false, residency);
+  auto header = reinterpret_cast<const _val_off_header_t*>(_val_offs.const_data());
+  int header_size = sizeof(_val_off_header_t) / sizeof(int32_t);
+  int val_num = _trie.value_num();
+  if (val_num < 0) {
+    std::ifstream len_file(rsc_dir + "/morph.val.len", std::ios::binary | std::ios::ate);
+    val_num = len_file ? static_cast<int>(len_file.tellg() / sizeof(int16_t)) : -1;
+  }
+  auto offsets = _val_offs.const_data() + header_size;
+  // the others offsets are checked when each value is parsed, so that they are not faulted in at open
+  if (_val_offs.size() < header_size || header->magic != VAL_OFF_MAGIC || header->val_num < 0 ||
+      header->val_num != val_num || header->val_size != _value.size() ||
+      _val_offs.size() != header_size + val_num + 1 || offsets[0] != 0 || offsets[val_num] != _value.size()) {
+    BOOST_LOG_TRIVIAL(warning) << "morph.val.off does not match dictionary. offsets are summed from morph.val.len";
+    _val_offs.close();
+    return false;
+  }
+  _val_off = offsets;
+  _val_num = val_num;
+  return true;
+}
+
+
+std::pair<std::vector<std::vector<morph_id_t>>, size_t> MorphDic::_parse(int idx) {
+  std::vector<std::vector<morph_id_t>> anal_results;
+  if (_val_recs == nullptr) {
+    anal_results = _parse_text(idx);
+  } else {
+    std::string idx_str = boost::lexical_cast<std::string>(idx);
+    const _val_rec_t& val_rec = _val_recs[idx];
+    HANAL_ASSERT(static_cast<uint64_t>(val_rec.anal_start) + val_rec.anal_num <= _val_header->anal_num,
+                 "Invalid analysis results of value: " + idx_str);
+    anal_results.resize(val_rec.anal_num);
+    for (int anal_idx = 0; anal_idx < val_rec.anal_num; ++anal_idx) {
+      const _anal_rec_t& anal_rec = _anal_recs[val_rec.anal_start + anal_idx];
+      HANAL_ASSERT(static_cast<uint64_t>(anal_rec.morph_start) + anal_rec.morph_num <= _val_header->morph_num,
+                   "Invalid morphemes of value: " + idx_str);
+      auto& anal_result = anal_results[anal_idx];
+      anal_result.reserve(anal_rec.morph_num);
+      for (auto morph_rec = _morph_recs + anal_rec.morph_start;
+           morph_rec < _morph_recs + anal_rec.morph_start + anal_rec.morph_num; ++morph_rec) {
+        // lexical form and its terminating zero are within lexical forms
+        HANAL_ASSERT(static_cast<uint64_t>(morph_rec->lex_start) + morph_rec->lex_len < _val_header->lex_size &&
+                     morph_rec->tag < static_cast<int>(SejongTag::_SIZE), "Invalid morpheme of value: " + idx_str);
+        anal_result.emplace_back(_morph_table.intern(_lexes + morph_rec->lex_start, morph_rec->lex_len,
+                                                     static_cast<SejongTag>(morph_rec->tag)));
+      }
+    }
+  }
+
+  // estimated heap bytes of vectors. morphemes are interned in table once and not counted
+  size_t bytes = sizeof(anal_results) + anal_results.capacity() * sizeof(std::vector<morph_id_t>);
+  for (auto& anal_result : anal_results) bytes += anal_result.capacity() * sizeof(morph_id_t);
+  return std::make_pair(std::move(anal_results), bytes);
+}
+
+
+std::vector<std::vector<morph_id_t>> MorphDic::_parse_text(int idx) {
+  HANAL_ASSERT(0 <= _val_off[idx] && _val_off[idx] < _val_off[idx + 1] && _val_off[idx + 1] <= _value.size() &&
+               _value.const_data()[_val_off[idx + 1] - 1] == L'\0',
+               "Invalid value offset: " + boost::lexical_cast<std::string>(idx));
+  const wchar_t* text = _value.const_data() + _val_off[idx];
+  std::vector<std::vector<morph_id_t>> anal_results(1);
+  int morph_start = 0;
+  int slash = -1;    // position of last '/' in current morpheme
+  for (int pos = 0; ; ++pos) {
+    wchar_t ch = text[pos];
+    if (ch == L'/') {
+      slash = pos;
+    } else if (ch == L'\0' || ch == L'\1' || ch == L'\2') {    // end of value, analysis result or morpheme
+      HANAL_ASSERT(slash >= morph_start, "Invalid morpheme format: " +
+                   Util::to_utf8(std::wstring(text + morph_start, text + pos)));
+      std::wstring tag(text + slash + 1, text + pos);
+      anal_results.back().emplace_back(_morph_table.intern(text + morph_start, slash - morph_start,
+                                                           Util::to_sejong(tag.c_str())));
+      if (ch == L'\0') break;
+      if (ch == L'\1') anal_results.emplace_back();
+      morph_start = pos + 1;
+      slash = -1;
+    }
+  }
+  return anal_results;
 }
 
 
@@ -11,32 +11,101 @@
 //////////////
 // includes //
 //////////////
+#include <cstdint>
 #include <list>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "hanal/AhoCorasick.hpp"
+#include "hanal/macro.hpp"
 #include "hanal/MappedDic.hpp"
-#include "hanal/Morph.hpp"
+#include "hanal/MorphTable.hpp"
 #include "hanal/Trie.hpp"
+#include "hanal/ValueCache.hpp"
 
 
 namespace hanal {
 
 
+/**
+ * header of binary value file (morph.val compiled by DicBuilder::compile_morph_val()). records of values, analysis
+ * results and morphemes follow in order, then zero terminated lexical forms
+ */
+struct _morph_val_header_t {
+  int32_t magic = 0;    ///< magic number (MorphDic::VAL_MAGIC)
+  int32_t val_num = 0;    ///< number of values
+  int32_t anal_num = 0;    ///< number of analysis results
+  int32_t morph_num = 0;    ///< number of morphemes
+  int32_t lex_size = 0;    ///< number of characters of lexical forms including terminating zeros
+};
+
+
+/**
+ * header of offsets file of text values (morph.val.off written by DicBuilder::index_morph_val()). start offsets of
+ * values and the total length follow in int32
+ */
+struct _val_off_header_t {
+  int32_t magic = 0;    ///< magic number (MorphDic::VAL_OFF_MAGIC)
+  int32_t val_num = 0;    ///< number of values
+  int32_t val_size = 0;    ///< number of characters of morph.val
+};
+
+
+/**
+ * value (analysis results) record of binary value file
+ */
+struct _val_rec_t {
+  uint32_t anal_start = 0;    ///< index of first analysis result
+  uint32_t anal_num = 0;    ///< number of analysis results
+};
+
+
+/**
+ * analysis result record of binary value file
+ */
+struct _anal_rec_t {
+  uint32_t morph_start = 0;    ///< index of first morpheme
+  uint32_t morph_num = 0;    ///< number of morphemes
+};
+
+
+/**
+ * morpheme record of binary value file
+ */
+struct _morph_rec_t {
+  uint32_t lex_start = 0;    ///< offset of zero terminated lexical form (in characters)
+  uint16_t lex_len = 0;    ///< length of lexical form
+  uint8_t tag = 0;    ///< part-of-speech tag (SejongTag)
+  uint8_t reserved = 0;    ///< reserved
+};
+
+
 /**
  * morpheme dictionary
  */
 class MorphDic {
  public:
+  static const int32_t VAL_MAGIC = 0x4C564E48;    ///< magic number of binary value file ("HNVL" in little endian)
+  static const int32_t VAL_OFF_MAGIC = 0x4F564E48;    ///< magic number of offsets file ("HNVO" in little endian)
+
+  typedef ValueCache<std::vector<std::vector<morph_id_t>>>::ref_t value_ref_t;    ///< reference of value
+
   virtual ~MorphDic();    ///< dtor
 
   /**
-   * @brief           open resources
-   * @param  rsc_dir  resource directory
+   * @brief                open resources. morph.val is either binary or text with morph.val.off (or morph.val.len
+   *                       for dictionaries built before offsets, or if morph.val.off does not match them)
+   * @param  rsc_dir       resource directory
+   * @param  aho_corasick  build Aho-Corasick automaton on syllable trie
+   * @param  residency     residency options of mapped files
+   * @param  val_cache     options of value cache
    */
-  void open(std::string rsc_dir);
+  void open(std::string rsc_dir, bool aho_corasick = false, const residency_t& residency = residency_t(),
+            const cache_option_t& val_cache = cache_option_t());
 
-  void close();    ///< close resources
+  void close();    ///< close resources. statistics of value cache are logged
 
   /**
    * @brief        lookup morpheme dictionary
@@ -46,18 +115,82 @@ class MorphDic {
   std::list<Trie::match_t> lookup(const wchar_t* text) const;
 
   /**
-   * @brief       get value (analysis result)
+   * @brief        lookup morpheme dictionary
+   * @param  text  text to search (not necessarily zero terminated)
+   * @param  len   length of text
+   * @return       all matches
+   */
+  std::list<Trie::match_t> lookup(const wchar_t* text, int len) const;
+
+  /**
+   * @brief           lookup morpheme dictionary without allocation
+   * @param  text     text to search (not necessarily zero terminated)
+   * @param  len      length of text
+   * @param  visitor  function called with each match (const Trie::match_t&) in order of length
+   * @return          number of matches
+   */
+  template<typename V>
+  int lookup(const wchar_t* text, int len, V visitor) const {
+    return _trie.search_common_prefix_matches(text, len, visitor);
+  }
+
+  TrieCursor cursor() const;    ///< cursor at root of syllable trie for incremental lookup
+
+  const AhoCorasick& aho_corasick() const;    ///< Aho-Corasick automaton. empty if not built at open
+
+  /**
+   * @brief       get value (analysis results of morpheme IDs). value is parsed at first access and cached. it is
+   *              safe to call from multiple threads without lock. with budget of cache, values may be evicted and
+   *              parsed again later, so hold the returned reference while using value
    * @param  idx  value index
-   * @return      value
+   * @return      reference of value
    */
-  const std::vector<SHDPTRVEC(Morph)>& value(int idx);
+  value_ref_t value(int idx);
+
+  const MorphTable& morph_table() const;    ///< table of morphemes whose IDs are in values
+
+  cache_stat_t cache_stat() const;    ///< statistics of value cache
 
  private:
   Trie _trie;    ///< syllable trie
+  AhoCorasick _aho_corasick;    ///< Aho-Corasick automaton on syllable trie
   MappedDic<wchar_t> _value;    ///< raw value of analysis results (vector of morphemes)
-  std::vector<wchar_t*> _val_idx;    ///< string index for raw value
-  /** @brief  parsed value (analysis results) cache */
-  std::vector<std::vector<SHDPTRVEC(Morph)>> _val_cache;
+  MappedDic<int32_t> _val_offs;    ///< offsets of raw values and total length (text format with morph.val.off)
+  std::vector<int32_t> _val_offs_sum;    ///< offsets summed from lengths (text format without morph.val.off)
+  const int32_t* _val_off = nullptr;    ///< offsets of raw values (either of above)
+  int _val_num = 0;    ///< number of values
+  const _morph_val_header_t* _val_header = nullptr;    ///< header (binary format)
+  const _val_rec_t* _val_recs = nullptr;    ///< value records (binary format)
+  const _anal_rec_t* _anal_recs = nullptr;    ///< analysis result records (binary format)
+  const _morph_rec_t* _morph_recs = nullptr;    ///< morpheme records (binary format)
+  const wchar_t* _lexes = nullptr;    ///< lexical forms (binary format)
+  MorphTable _morph_table;    ///< table of morphemes in parsed values
+  ValueCache<std::vector<std::vector<morph_id_t>>> _val_cache;    ///< parsed value (analysis results) cache
+
+  /**
+   * @brief             map offsets of text values (morph.val.off) if it matches the other files. its number of values
+   *                    is checked against trie (or morph.val.len if trie does not record it)
+   * @param  rsc_dir    resource directory
+   * @param  residency  residency options of mapped file
+   * @return            false if not found or not matched
+   */
+  bool _open_val_offs(std::string rsc_dir, const residency_t& residency);
+
+  /**
+   * @brief       parse value. only one thread parses a value at a time (the one which claims its cache slot).
+   *              records of binary format are checked to be within sections here, so that they are not faulted in
+   *              at open
+   * @param  idx  value index
+   * @return      (value, estimated heap bytes)
+   */
+  std::pair<std::vector<std::vector<morph_id_t>>, size_t> _parse(int idx);
+
+  /**
+   * @brief       parse value of text format. raw value is kept intact since morphemes are interned
+   * @param  idx  value index
+   * @return      value
+   */
+  std::vector<std::vector<morph_id_t>> _parse_text(int idx);
 };
 
 
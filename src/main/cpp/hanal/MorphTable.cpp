@@ -0,0 +1,127 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#include "hanal/MorphTable.hpp"
+
+
+//////////////
+// includes //
+//////////////
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "hanal/Except.hpp"
+#include "hanal/Util.hpp"
+
+
+namespace hanal {
+
+
+////////////////////
+// static members //
+////////////////////
+const morph_id_t MorphTable::LOCAL_BIT;
+const int MorphTable::_FIRST_BLOCK_BITS;
+const int MorphTable::_MIN_LEX_CHUNK_SIZE;
+const int MorphTable::_LEX_CHUNK_SIZE;
+
+
+////////////////////
+// ctors and dtor //
+////////////////////
+MorphTable::MorphTable(const MorphTable* base) : _base(base) {
+}
+
+
+/////////////
+// methods //
+/////////////
+morph_id_t MorphTable::intern(const wchar_t* lex, int len, SejongTag tag) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto found = _ids.find(_key_t{lex, len, tag});    // looked up in place without copying lexical form
+  if (found != _ids.end()) return found->second;
+
+  HANAL_ASSERT(_size < static_cast<int>(LOCAL_BIT - (1u << _FIRST_BLOCK_BITS)), "Too many morphemes");
+  if (_lex_chunk_used + len + 1 > _lex_chunk_size) {
+    _lex_chunk_size = std::min(std::max(_lex_chunk_size * 2, _MIN_LEX_CHUNK_SIZE), _LEX_CHUNK_SIZE);
+    _lex_chunk_size = std::max(_lex_chunk_size, len + 1);
+    _lex_chunks.emplace_back(new wchar_t[_lex_chunk_size]);
+    _lex_chunk_used = 0;
+  }
+  wchar_t* lex_cpy = _lex_chunks.back().get() + _lex_chunk_used;
+  std::copy(lex, lex + len, lex_cpy);
+  lex_cpy[len] = L'\0';
+  _lex_chunk_used += len + 1;
+
+  uint32_t num = _size + (1u << _FIRST_BLOCK_BITS);
+  int block_idx = (31 - __builtin_clz(num)) - _FIRST_BLOCK_BITS;
+  auto& block = _blocks[block_idx];
+  if (!block) block.reset(new _entry_t[(1u << _FIRST_BLOCK_BITS) << block_idx]);
+  _entry_t& entry = block[num - ((1u << _FIRST_BLOCK_BITS) << block_idx)];
+  entry.lex = lex_cpy;
+  entry.tag = tag;
+
+  morph_id_t id = (_base == nullptr) ? _size : (_size | LOCAL_BIT);
+  _size += 1;
+  _ids.emplace(_key_t{lex_cpy, len, tag}, id);
+  return id;
+}
+
+
+const wchar_t* MorphTable::lex(morph_id_t id) const {
+  return _entry(id).lex;
+}
+
+
+SejongTag MorphTable::tag(morph_id_t id) const {
+  return _entry(id).tag;
+}
+
+
+int MorphTable::size() const {
+  return _size;
+}
+
+
+void MorphTable::clear() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  for (auto& block : _blocks) block.reset();
+  _size = 0;
+  _lex_chunks.clear();
+  _lex_chunk_size = 0;
+  _lex_chunk_used = 0;
+  _ids.clear();
+}
+
+
+std::string MorphTable::str(morph_id_t id) const {
+  std::ostringstream oss;
+  oss << Util::to_utf8(lex(id)) << "/" << Util::to_utf8(Util::from_sejong(tag(id)));
+  return oss.str();
+}
+
+
+std::string MorphTable::str(const std::vector<morph_id_t>& anal_result) const {
+  std::ostringstream oss;
+  for (auto id : anal_result) {
+    if (oss.str().length() > 0) oss << " + ";
+    oss << str(id);
+  }
+  return oss.str();
+}
+
+
+const MorphTable::_entry_t& MorphTable::_entry(morph_id_t id) const {
+  if (_base != nullptr && (id & LOCAL_BIT) == 0) return _base->_entry(id);
+  uint32_t num = (id & ~LOCAL_BIT) + (1u << _FIRST_BLOCK_BITS);
+  int block_idx = (31 - __builtin_clz(num)) - _FIRST_BLOCK_BITS;
+  return _blocks[block_idx][num - ((1u << _FIRST_BLOCK_BITS) << block_idx)];
+}
+
+
+}    // namespace hanal
@@ -0,0 +1,124 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#ifndef HANAL_MORPHTABLE_HPP
+#define HANAL_MORPHTABLE_HPP
+
+
+//////////////
+// includes //
+//////////////
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>    // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "hanal/SejongTag.hpp"
+
+
+namespace hanal {
+
+
+typedef uint32_t morph_id_t;    ///< ID of morpheme (lexical form and part-of-speech tag) interned by MorphTable
+
+
+/**
+ * table of morphemes which interns each distinct pair of lexical form and tag once and hands out its ID. entries are
+ * never moved, so reading entry of an ID takes no lock while the other thread interns. IDs must be passed to readers
+ * with synchronization (as values of MorphDic are published by its cache). a local table may be put over a base table
+ * for temporary morphemes (like estimated unknown words): its own IDs have LOCAL_BIT and the others are looked up in
+ * the base table
+ */
+class MorphTable {
+ public:
+  static const morph_id_t LOCAL_BIT = 0x80000000;    ///< bit of IDs of local table
+
+  /**
+   * @brief        ctor
+   * @param  base  base table. nullptr for base table itself
+   */
+  explicit MorphTable(const MorphTable* base = nullptr);
+
+  /**
+   * @brief        intern morpheme
+   * @param  lex   lexical form (not necessarily zero terminated). copied into table at first intern
+   * @param  len   length of lexical form
+   * @param  tag   part-of-speech tag
+   * @return       ID of morpheme
+   */
+  morph_id_t intern(const wchar_t* lex, int len, SejongTag tag);
+
+  const wchar_t* lex(morph_id_t id) const;    ///< get zero terminated lexical form of morpheme
+
+  SejongTag tag(morph_id_t id) const;    ///< get part-of-speech tag of morpheme
+
+  int size() const;    ///< number of morphemes interned in this table (not including base table)
+
+  void clear();    ///< remove all morphemes. IDs handed out are no longer valid
+
+  std::string str(morph_id_t id) const;    ///< get string of morpheme ("lex/TAG") for debugging
+
+  /**
+   * @brief               get string of morphemes for debugging
+   * @param  anal_result  analysis result (vector of morpheme IDs)
+   * @return              string
+   */
+  std::string str(const std::vector<morph_id_t>& anal_result) const;
+
+ private:
+  struct _entry_t {    ///< entry of morpheme
+    const wchar_t* lex = nullptr;    ///< zero terminated lexical form in lexical form chunks
+    SejongTag tag = SejongTag::_SIZE;    ///< part-of-speech tag
+  };
+
+  struct _key_t {    ///< key of morpheme which points to lexical form (of caller at lookup, of table at insert)
+    const wchar_t* lex;    ///< lexical form (not necessarily zero terminated)
+    int len;    ///< length of lexical form
+    SejongTag tag;    ///< part-of-speech tag
+  };
+
+  struct _key_hash_t {    ///< hash of key (FNV-1a over characters and tag)
+    size_t operator()(const _key_t& key) const {
+      size_t hash = 2166136261u ^ static_cast<size_t>(key.tag);
+      for (int idx = 0; idx < key.len; ++idx) hash = (hash ^ static_cast<size_t>(key.lex[idx])) * 16777619u;
+      return hash;
+    }
+  };
+
+  struct _key_equal_t {    ///< equality of keys
+    bool operator()(const _key_t& lhs, const _key_t& rhs) const {
+      return lhs.tag == rhs.tag && lhs.len == rhs.len && std::equal(lhs.lex, lhs.lex + lhs.len, rhs.lex);
+    }
+  };
+
+  static const int _FIRST_BLOCK_BITS = 6;    ///< bits of size of the first block. block k has (64 << k) entries
+  static const int _MIN_LEX_CHUNK_SIZE = 256;    ///< number of characters of the first lexical form chunk
+  static const int _LEX_CHUNK_SIZE = 64 * 1024;    ///< maximum number of characters of a lexical form chunk
+
+  const MorphTable* _base = nullptr;    ///< base table
+  /** @brief  blocks of entries which grow geometrically. they are allocated once and never moved */
+  std::array<std::unique_ptr<_entry_t[]>, 32 - _FIRST_BLOCK_BITS> _blocks;
+  int _size = 0;    ///< number of entries
+  /** @brief  chunks of lexical forms. they double from the minimum size, so a small (local) table stays small */
+  std::vector<std::unique_ptr<wchar_t[]>> _lex_chunks;
+  int _lex_chunk_size = 0;    ///< number of characters of the last chunk
+  int _lex_chunk_used = 0;    ///< characters used in the last chunk
+  std::unordered_map<_key_t, morph_id_t, _key_hash_t, _key_equal_t> _ids;    ///< key to ID map
+  std::mutex _mutex;    ///< mutex of interning
+
+  const _entry_t& _entry(morph_id_t id) const;    ///< get entry of ID of this table or base table
+};
+
+
+}    // namespace hanal
+
+
+#endif  // HANAL_MORPHTABLE_HPP
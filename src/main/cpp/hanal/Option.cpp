@@ -12,16 +12,63 @@
 // includes //
 //////////////
 #include <string>
+#include <vector>
+
+#include "boost/algorithm/string.hpp"
+#include "boost/lexical_cast.hpp"
+#include "hanal/Except.hpp"
 
 
 namespace hanal {
 
 
+///////////////
+// functions //
+///////////////
+/**
+ * @brief         parse boolean option value
+ * @param  key    option key
+ * @param  value  option value
+ * @return        boolean value
+ */
+static bool _to_bool(const std::string& key, const std::string& value) {
+  if (value == "true" || value == "1") return true;
+  if (value == "false" || value == "0") return false;
+  HANAL_THROW("Invalid boolean value of option '" + key + "': " + value);
+}
+
+
+/**
+ * @brief         parse integer option value
+ * @param  key    option key
+ * @param  value  option value
+ * @return        integer value
+ */
+static int _to_int(const std::string& key, const std::string& value) {
+  try {
+    return boost::lexical_cast<int>(value);
+  } catch (boost::bad_lexical_cast&) {
+    HANAL_THROW("Invalid integer value of option '" + key + "': " + value);
+  }
+}
+
+
+/**
+ * @brief       whether option is used only at open (dictionaries are loaded with it) or not
+ * @param  key  option key
+ * @return      true if open only
+ */
+static bool _is_open_only(const std::string& key) {
+  return key == "aho_corasick" || key == "populate" || key == "willneed" || key == "hugepage" || key == "random" ||
+         key == "mlock" || key == "prefetch" || key == "val_cache_mb" || key == "val_cache_warm_up";
+}
+
+
 ////////////////////
 // ctors and dtor //
 ////////////////////
 Option::Option(std::string opt_str) {
-  // TODO(krikit): parse option string
+  _parse(opt_str, true);
 }
 
 
@@ -29,8 +76,51 @@ Option::Option(std::string opt_str) {
 // methods //
 /////////////
 Option Option::override(std::string opt_str) {
-  // TODO(krikit): parse option string and return overrided options
-  return *this;
+  Option overrided = *this;
+  overrided._parse(opt_str, false);
+  return overrided;
+}
+
+
+void Option::_parse(std::string opt_str, bool at_open) {
+  std::vector<std::string> opts;
+  boost::split(opts, opt_str, boost::is_any_of(", \t\r\n"), boost::token_compress_on);
+  for (auto& opt : opts) {
+    if (opt.empty()) continue;
+    auto delim_pos = opt.find('=');
+    std::string key = opt.substr(0, delim_pos);
+    std::string value = (delim_pos == std::string::npos) ? "true" : opt.substr(delim_pos + 1);
+    HANAL_ASSERT(at_open || !_is_open_only(key), "Option only at open: " + key);
+    if (key == "word_merge") {
+      word_merge = _to_int(key, value);
+    } else if (key == "anal_back") {
+      anal_back = _to_bool(key, value);
+    } else if (key == "aho_corasick") {
+      aho_corasick = _to_bool(key, value);
+    } else if (key == "populate") {
+      residency.populate = _to_bool(key, value);
+    } else if (key == "willneed") {
+      residency.willneed = _to_bool(key, value);
+    } else if (key == "hugepage") {
+      residency.hugepage = _to_bool(key, value);
+    } else if (key == "random") {
+      residency.random = _to_bool(key, value);
+    } else if (key == "mlock") {
+      residency.mlock = _to_bool(key, value);
+    } else if (key == "prefetch") {    // same to willneed: the kernel reads ahead in background
+      // only turns read-ahead on, so that "willneed,prefetch=false" does not turn it off again
+      if (_to_bool(key, value)) residency.willneed = true;
+    } else if (key == "val_cache_mb") {
+      int mega_bytes = _to_int(key, value);
+      HANAL_ASSERT(mega_bytes >= 0, "Invalid value of option '" + key + "': " + value);
+      val_cache.budget = static_cast<size_t>(mega_bytes) * 1024 * 1024;
+    } else if (key == "val_cache_warm_up") {
+      val_cache.warm_up = _to_int(key, value);
+      HANAL_ASSERT(val_cache.warm_up >= 0, "Invalid value of option '" + key + "': " + value);
+    } else {
+      HANAL_THROW("Unknown option: " + key);
+    }
+  }
 }
 
 
@@ -14,6 +14,9 @@
 //////////////
 #include <string>
 
+#include "hanal/MappedDic.hpp"
+#include "hanal/ValueCache.hpp"
+
 
 namespace hanal {
 
@@ -25,15 +28,38 @@ class Option {
  public:
   int word_merge = 1;    ///< word merge count. default: 1
   bool anal_back = true;    ///< analyze backward. default: true
+  bool aho_corasick = false;    ///< lookup whole word in one pass by Aho-Corasick automaton (open). default: false
+  /**
+   * residency of dictionary files (open only). keys are populate, willneed, hugepage, random, mlock and prefetch
+   * (alias of willneed which only turns it on). default: all false
+   */
+  residency_t residency;
+  /**
+   * value cache of morpheme dictionary (open only). keys are val_cache_mb (budget in MB, 0 for unbounded) and
+   * val_cache_warm_up (number of values loaded at open). default: unbounded without warm-up
+   */
+  cache_option_t val_cache;
 
-  explicit Option(std::string opt_str);    ///< ctor
+  /**
+   * @brief           ctor
+   * @param  opt_str  options separated by comma or white space. each one is "key=value" or "key" (for true)
+   */
+  explicit Option(std::string opt_str);
 
   /**
-   * @brief           run-time override option
+   * @brief           run-time override option. open only options are not allowed
    * @param  opt_str  run-time option
    * @return          overrided option
    */
   Option override(std::string opt_str);
+
+ private:
+  /**
+   * @brief           parse option string and set options
+   * @param  opt_str  option string
+   * @param  at_open  whether parsed at open or not (open only options throw if not)
+   */
+  void _parse(std::string opt_str, bool at_open);
 };
 
 
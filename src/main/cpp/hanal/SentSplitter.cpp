@@ -0,0 +1,92 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#include "hanal/SentSplitter.hpp"
+
+
+//////////////
+// includes //
+//////////////
+#include <vector>
+
+#include "hanal/Char.hpp"
+#include "hanal/CharBuffer.hpp"
+
+
+namespace hanal {
+
+
+////////////////////
+// ctors and dtor //
+////////////////////
+SentSplitter::SentSplitter(const CharBuffer& chars): _chars(&chars) {
+}
+
+
+/////////////
+// methods //
+/////////////
+bool SentSplitter::next(sent_t* sent) {
+  if (_char_idx >= _chars->size()) return false;
+  int char_end = _find_end(_char_idx);
+  sent->begin = _chars->starts[_char_idx];
+  sent->end = _chars->ends[char_end - 1];
+  sent->char_idx = _char_idx;
+  sent->char_end = char_end;
+  sent->cp_begin = _to_cp(sent->begin);
+  sent->cp_end = _to_cp(sent->end);
+  _char_idx = char_end;
+  return true;
+}
+
+
+std::vector<SentSplitter::sent_t> SentSplitter::split(const CharBuffer& chars) {
+  std::vector<sent_t> sents;
+  SentSplitter splitter(chars);
+  sent_t sent;
+  while (splitter.next(&sent)) sents.emplace_back(sent);
+  return sents;
+}
+
+
+int SentSplitter::_find_end(int start) const {
+  auto& types = _chars->types;
+  int size = _chars->size();
+  for (int idx = start; idx < size; ++idx) {
+    if (types[idx] != Char::Type::PERIOD && types[idx] != Char::Type::ELLIPSIS) continue;
+    int end = idx + 1;
+    while (end < size && (types[end] == Char::Type::PERIOD || types[end] == Char::Type::ELLIPSIS)) end += 1;
+    // closing quotes in the same word
+    while (end < size && types[end] == Char::Type::QUOTE && !_chars->is_word_start(end)) end += 1;
+    if (end == size || _chars->is_word_start(end)) return end;
+    idx = end - 1;    // not end of sentence. e.g. "3.14", "a.k.a"
+  }
+  return size;
+}
+
+
+int SentSplitter::_to_cp(int unit_pos) {
+  if (_chars->text != nullptr) {
+    for (; _unit_pos < unit_pos; ++_unit_pos) {
+      if ((_chars->text[_unit_pos] & 0xC0) != 0x80) _cp_pos += 1;    // not continuation byte
+    }
+    return _cp_pos;
+  }
+
+  // UTF-16 (or UTF-32) text is not kept, but only supplementary characters take two units (a surrogate pair). the others
+  // including white spaces and conjoining jamo (composed into a syllable) take a unit per code point
+  for (; _cp_char_idx < _chars->size() && _chars->ends[_cp_char_idx] <= unit_pos; ++_cp_char_idx) {
+    if (_chars->wchars[_cp_char_idx] > 0xFFFF) {
+      _cp_pos -= _chars->ends[_cp_char_idx] - _chars->starts[_cp_char_idx] - 1;    // 1 in UTF-16, 0 in UTF-32
+    }
+  }
+  _cp_pos += unit_pos - _unit_pos;
+  _unit_pos = unit_pos;
+  return _cp_pos;
+}
+
+
+}    // namespace hanal
@@ -0,0 +1,80 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#ifndef HANAL_SENTSPLITTER_HPP
+#define HANAL_SENTSPLITTER_HPP
+
+
+//////////////
+// includes //
+//////////////
+#include <vector>
+
+
+namespace hanal {
+
+
+class CharBuffer;
+
+
+/**
+ * streaming sentence splitter over characters of a document.
+ * sentence ends with periods (or ellipses) followed by optional quotes and white space (or end of document)
+ */
+class SentSplitter {
+ public:
+  struct sent_t {    ///< span of sentence
+    int begin = -1;    ///< start position (code unit offset, inclusive) of original text
+    int end = -1;    ///< end position (code unit offset, exclusive) of original text
+    int char_idx = -1;    ///< start character index
+    int char_end = -1;    ///< end character index (exclusive)
+    int cp_begin = -1;    ///< start position (code point offset, inclusive) of original text
+    int cp_end = -1;    ///< end position (code point offset, exclusive) of original text
+  };
+
+  explicit SentSplitter(const CharBuffer& chars);    ///< ctor
+
+  /**
+   * @brief        get next sentence
+   * @param  sent  [out] next sentence
+   * @return       false if there's no more sentence
+   */
+  bool next(sent_t* sent);
+
+  /**
+   * @brief         split all sentences
+   * @param  chars  characters of document
+   * @return        sentences
+   */
+  static std::vector<sent_t> split(const CharBuffer& chars);
+
+ private:
+  const CharBuffer* _chars = nullptr;    ///< characters of document
+  int _char_idx = 0;    ///< start character index of next sentence
+  int _unit_pos = 0;    ///< code unit offset counted to code points so far
+  int _cp_pos = 0;    ///< code point offset of _unit_pos
+  int _cp_char_idx = 0;    ///< index of first character not counted to code points yet (UTF-16/UTF-32 text)
+
+  /**
+   * @brief            count code points of original text from the last counted position
+   * @param  unit_pos  code unit offset to count up to (not less than the last one)
+   * @return           code point offset of the position. for UTF-16 text, surrogate pairs are found in characters
+   */
+  int _to_cp(int unit_pos);
+
+  /**
+   * @brief         find end of sentence starting at the position
+   * @param  start  start character index
+   * @return        end character index (exclusive)
+   */
+  int _find_end(int start) const;
+};
+
+
+}    // namespace hanal
+
+
+#endif  // HANAL_SENTSPLITTER_HPP
@@ -23,10 +23,10 @@ StateFeatDic::~StateFeatDic() {
 }
 
 
-void StateFeatDic::open(std::string rsc_dir) {
+void StateFeatDic::open(std::string rsc_dir, const residency_t& residency) {
   close();
-  _trie.open(rsc_dir + "/state_feat.trie");
-  _value.open(rsc_dir + "/state_feat.val");
+  _trie.open(rsc_dir + "/state_feat.trie", residency);
+  _value.open(rsc_dir + "/state_feat.val", false, residency);
   BOOST_LOG_TRIVIAL(info) << "State-features dictionary loaded";
 }
 
@@ -29,10 +29,11 @@ class StateFeatDic {
   virtual ~StateFeatDic();    ///< dtor
 
   /**
-   * @brief           open resources
-   * @param  rsc_dir  resource directory
+   * @brief             open resources
+   * @param  rsc_dir    resource directory
+   * @param  residency  residency options of mapped files
    */
-  void open(std::string rsc_dir);
+  void open(std::string rsc_dir, const residency_t& residency = residency_t());
 
   void close();    ///< close resources
 
@@ -11,17 +11,37 @@
 // includes //
 //////////////
 #include <algorithm>
+#include <cwchar>
 #include <list>
 #include <string>
+#include <vector>
 
 #include "boost/lexical_cast.hpp"
 #include "boost/log/trivial.hpp"
 #include "hanal/Except.hpp"
+#include "hanal/Jamo.hpp"
 
 
 namespace hanal {
 
 
+////////////////////
+// static members //
+////////////////////
+const int32_t Trie::MAGIC;
+
+
+////////////////////
+// ctors and dtor //
+////////////////////
+TrieCursor::TrieCursor(const Trie& trie): _trie(&trie) {}
+
+
+Trie::~Trie() {
+  close();
+}
+
+
 /////////////
 // methods //
 /////////////
@@ -38,15 +58,134 @@ std::string _trie_node_t::str(const _trie_node_t* root_node) const {
 }
 
 
-void Trie::open(std::string path) {
-  MappedDic<_trie_node_t>::open(path, false);
+void _trie_alphabet_t::build(const int32_t* chars, int size) {
+  clear();
+  std::array<std::vector<int32_t>, 256> bmp_blocks;
+  for (int idx = 0; idx < size; ++idx) {
+    auto ucs = static_cast<uint32_t>(chars[idx]);
+    if (ucs <= 0xFFFF) {
+      auto& block = bmp_blocks[ucs >> 8];
+      if (block.empty()) block.resize(256, 0);
+      block[ucs & 0xFF] = idx + 1;
+    } else {
+      _ext.emplace_back(static_cast<wchar_t>(ucs), idx + 1);
+    }
+  }
+  // block 0 is reserved for empty block
+  for (int upper = 0; upper < 256; ++upper) {
+    if (bmp_blocks[upper].empty()) continue;
+    _block_idx[upper] = _blocks.size() / 256;
+    _blocks.insert(_blocks.end(), bmp_blocks[upper].begin(), bmp_blocks[upper].end());
+  }
+  std::sort(_ext.begin(), _ext.end());
+}
+
+
+void _trie_alphabet_t::clear() {
+  _block_idx.fill(0);
+  _blocks.assign(256, 0);
+  _ext.clear();
+}
+
+
+int _trie_alphabet_t::_code_ext(wchar_t ch) const {
+  auto found = std::lower_bound(_ext.begin(), _ext.end(), std::make_pair(ch, 0));
+  if (found == _ext.end() || found->first != ch) return 0;
+  return found->second;
+}
+
 
+void Trie::open(std::string path, const residency_t& residency) {
+  close();
+  _dic.open(path, false, residency);
+  auto data = _dic.const_data();
+  auto header = reinterpret_cast<const _trie_header_t*>(data);
+  int data_size = _dic.size();    // number of int32_t
+  HANAL_ASSERT(data_size * sizeof(int32_t) >= sizeof(_trie_node_t), "Too small trie file: " + path);
+  if (data_size * sizeof(int32_t) >= sizeof(_trie_header_t) && header->magic == MAGIC) {
+    _format = static_cast<Format>(header->format);
+    int header_size = sizeof(_trie_header_t) / sizeof(int32_t);
+    HANAL_ASSERT(_format == Format::DOUBLE_ARRAY || _format == Format::PACKED || _format == Format::DAWG,
+                 "Unknown trie format: " + boost::lexical_cast<std::string>(header->format));
+    HANAL_ASSERT(header->alphabet_size >= 0 && header->node_num > 0, "Invalid header of trie file: " + path);
+    // sizes are in 64 bits not to overflow with counts of corrupt header
+    int64_t body_size = static_cast<int64_t>(header->node_num) * sizeof(_da_cell_t) / sizeof(int32_t);
+    if (_format == Format::PACKED) {
+      body_size = (static_cast<int64_t>(header->node_num) * sizeof(_packed_node_t)
+                   + (static_cast<int64_t>(header->node_num) + 31) / 32 * sizeof(_rank_block_t)) / sizeof(int32_t);
+    } else if (_format == Format::DAWG) {
+      // transitions are followed by number of values and values
+      body_size = static_cast<int64_t>(header->node_num) * sizeof(_dawg_trans_t) / sizeof(int32_t);
+      int64_t value_pos = header_size + header->alphabet_size + body_size;
+      HANAL_ASSERT(value_pos < data_size && data[value_pos] >= 0, "Invalid size of trie file: " + path);
+      body_size += 1 + data[value_pos];
+    }
+    HANAL_ASSERT(header_size + header->alphabet_size + body_size == data_size, "Invalid size of trie file: " + path);
+    _chars = data + header_size;
+    _alphabet.build(_chars, header->alphabet_size);
+    _node_num = header->node_num;
+    if (_format == Format::DOUBLE_ARRAY) {
+      _cells = reinterpret_cast<const _da_cell_t*>(_chars + header->alphabet_size);
+    } else if (_format == Format::PACKED) {
+      _packed = reinterpret_cast<const _packed_node_t*>(_chars + header->alphabet_size);
+      _rank_blocks = reinterpret_cast<const _rank_block_t*>(_packed + _node_num);
+      _build_root_jump();
+    } else {
+      _dawg = reinterpret_cast<const _dawg_trans_t*>(_chars + header->alphabet_size);
+      _dawg_values = reinterpret_cast<const int32_t*>(_dawg + _node_num) + 1;
+      _build_root_jump();
+    }
+  } else {
+    // legacy format without header. root node has no character
+    _format = Format::LEGACY;
+    HANAL_ASSERT((data_size * sizeof(int32_t)) % sizeof(_trie_node_t) == 0,
+                 "Invalid size of trie file: " + path);
+    _nodes = reinterpret_cast<const _trie_node_t*>(data);
+    _node_num = data_size * sizeof(int32_t) / sizeof(_trie_node_t);
+    HANAL_ASSERT(_nodes[0].ch == 0, "Invalid root node of trie file: " + path);
 #if defined(TRACE) && defined(DEBUG)
-  const _trie_node_t* root_node = data();
-  for (int i = 0; i < sizeof(root_node) / sizeof(_trie_node_t); ++i) {
-    BOOST_LOG_TRIVIAL(trace) << root_node[i].str(root_node);
-  }
+    for (int i = 0; i < _node_num; ++i) {
+      BOOST_LOG_TRIVIAL(trace) << _nodes[i].str(_nodes);
+    }
 #endif
+    _build_root_jump();
+  }
+}
+
+
+void Trie::close() {
+  _dic.close();
+  _format = Format::LEGACY;
+  _nodes = nullptr;
+  _cells = nullptr;
+  _packed = nullptr;
+  _rank_blocks = nullptr;
+  _dawg = nullptr;
+  _dawg_values = nullptr;
+  _chars = nullptr;
+  _node_num = 0;
+  _alphabet.clear();
+  _root_jump.clear();
+  _is_sorted = false;
+}
+
+
+TrieCursor TrieCursor::clone() const {
+  return *this;
+}
+
+
+Trie::Format Trie::format() const {
+  return _format;
+}
+
+
+int Trie::value_num() const {
+  if (_node_num == 0) return -1;
+  if (_format == Format::DAWG) return _dawg_values[-1];    // number of values precedes them
+  if (_format != Format::PACKED) return -1;
+  const _rank_block_t& last = _rank_blocks[(_node_num - 1) / 32];
+  return last.rank + __builtin_popcount(last.bits);
 }
 
 
@@ -58,7 +197,15 @@ boost::optional<int> Trie::find(const std::wstring& key) const {
 boost::optional<int> Trie::find(const wchar_t* key) const {
   HANAL_ASSERT(key != nullptr, "Null key");
   if (*key == L'\0') return boost::none;
-  return _find(key, const_data());
+  int node = 0;
+  int weight = 0;
+  for (; *key != L'\0'; ++key) {
+    node = _child(node, *key, &weight);
+    if (node < 0) return boost::none;
+  }
+  int val_idx = _value(node, weight);
+  if (val_idx < 0) return boost::none;
+  return boost::optional<int>(val_idx);
 }
 
 
@@ -69,53 +216,166 @@ std::list<Trie::match_t> Trie::search_common_prefix_matches(const std::wstring&
 
 std::list<Trie::match_t> Trie::search_common_prefix_matches(const wchar_t* text) const {
   HANAL_ASSERT(text != nullptr, "Null text");
+  return search_common_prefix_matches(text, wcslen(text));
+}
+
+
+std::list<Trie::match_t> Trie::search_common_prefix_matches(const wchar_t* text, int len) const {
   std::list<match_t> found;
-  _search(text, const_data(), &found, 0);
+  search_common_prefix_matches(text, len, [&found] (const match_t& match) { found.emplace_back(match); });
   return found;
 }
 
 
-boost::optional<int> Trie::_find(const wchar_t* key, const _trie_node_t* node) const {
-  BOOST_LOG_TRIVIAL(trace) << "key: [" << key << "], " << node->str(const_data());
-  if (node->child_start <= 0 || node->child_num <= 0) return boost::none;
-  auto begin = node + node->child_start;
-  auto end = begin + node->child_num;
-  auto pred = [&key] (const _trie_node_t& _node) { return _node.ch == *key; };
-  auto found_node = std::find_if(begin, end, pred);
-  if (found_node == end) {
-    BOOST_LOG_TRIVIAL(trace) << "  not found";
-    return boost::none;
-  } else {
-    BOOST_LOG_TRIVIAL(trace) << "  found: " << found_node->str(const_data());
-    key += 1;
-    if (*key == L'\0') {
-      if (found_node->val_idx >= 0) {
-        return boost::optional<int>(found_node->val_idx);
-      } else {
-        return boost::none;
-      }
+int Trie::search_common_prefix_matches(const wchar_t* text, int len, match_t* matches, int capacity) const {
+  HANAL_ASSERT(text != nullptr && matches != nullptr, "Null text or matches");
+  if (capacity <= 0) return 0;
+  int match_num = 0;
+  int node = 0;
+  int weight = 0;
+  for (int idx = 0; idx < len && text[idx] != L'\0'; ++idx) {
+    node = _child(node, text[idx], &weight);
+    if (node < 0) break;
+    int val_idx = _value(node, weight);
+    if (val_idx < 0) continue;
+    matches[match_num++] = match_t(idx + 1, val_idx);
+    if (match_num >= capacity) break;
+  }
+  return match_num;
+}
+
+
+TrieCursor Trie::cursor() const {
+  return TrieCursor(*this);
+}
+
+
+int Trie::_child(int node, wchar_t ch, int* weight) const {
+  if (_format == Format::DOUBLE_ARRAY) {
+    int code = _alphabet.code(ch);
+    if (code == 0) return -1;
+    int next = _cells[node].base + code;
+    return (next < _node_num && _cells[next].check == node) ? next : -1;
+  }
+  if (_format == Format::DAWG) {
+    int next = -1;
+    if (node == 0 && !_root_jump.empty() && Jamo::is_syllable(ch)) {
+      next = _root_jump[ch - L'가'];
     } else {
-      return _find(key, found_node);
+      int code = _alphabet.code(ch);
+      const _dawg_trans_t* parent = _dawg + node;
+      int first = parent->child & 0x7FFFFFFF;
+      if (code == 0 || first == 0) return -1;
+      auto begin = _dawg + first;
+      int num = parent->child_num;
+      while (num > 1) {
+        int half = num / 2;
+        begin = (begin[half].code <= code) ? begin + half : begin;
+        num -= half;
+      }
+      if (begin->code == code) next = begin - _dawg;
+    }
+    if (next >= 0 && weight != nullptr) *weight += _dawg[next].weight;
+    return next;
+  }
+  if (node == 0 && !_root_jump.empty() && Jamo::is_syllable(ch)) return _root_jump[ch - L'가'];
+  if (_format == Format::PACKED) {
+    int code = _alphabet.code(ch);
+    const _packed_node_t* parent = _packed + node;
+    int offset = parent->child & 0x7FFFFFFF;
+    if (code == 0 || offset == 0) return -1;
+    auto begin = parent + offset;
+    int num = parent->child_num;
+    while (num > 1) {
+      int half = num / 2;
+      begin = (begin[half].code <= code) ? begin + half : begin;
+      num -= half;
     }
+    return (begin->code == code) ? (begin - _packed) : -1;
+  }
+  const _trie_node_t* parent = _nodes + node;
+  if (parent->child_start <= 0 || parent->child_num <= 0) return -1;
+  auto begin = parent + parent->child_start;
+  if (!_is_sorted) {
+    auto end = begin + parent->child_num;
+    auto found = std::find_if(begin, end, [&ch] (const _trie_node_t& _node) { return _node.ch == ch; });
+    return (found == end) ? -1 : (found - _nodes);
   }
+  // branch-free binary search over sorted siblings
+  int num = parent->child_num;
+  while (num > 1) {
+    int half = num / 2;
+    begin = (begin[half].ch <= ch) ? begin + half : begin;
+    num -= half;
+  }
+  return (begin->ch == ch) ? (begin - _nodes) : -1;
+}
+
+
+int Trie::_children(int node, int* first) const {
+  HANAL_ASSERT(_format == Format::LEGACY || _format == Format::PACKED, "Nodes are not in tree form");
+  *first = -1;
+  if (_format == Format::PACKED) {
+    int offset = _packed[node].child & 0x7FFFFFFF;
+    if (offset == 0) return 0;
+    *first = node + offset;
+    return _packed[node].child_num;
+  }
+  if (_nodes[node].child_start <= 0 || _nodes[node].child_num <= 0) return 0;
+  *first = node + _nodes[node].child_start;
+  return _nodes[node].child_num;
 }
 
 
-void Trie::_search(const wchar_t* text, const _trie_node_t* node, std::list<Trie::match_t>* matches, int len) const {
-  BOOST_LOG_TRIVIAL(trace) << "text(" << len << "): [" << text << "], " << node->str(const_data());
-  if (*text == '\0' || node->child_start <= 0 || node->child_num <= 0) return;
-  auto begin = node + node->child_start;
-  auto end = begin + node->child_num;
-  auto pred = [&text] (const _trie_node_t& _node) { return _node.ch == *text; };
-  auto match_node = std::find_if(begin, end, pred);
-  if (match_node == end) {
-    BOOST_LOG_TRIVIAL(trace) << "  not matched";
+wchar_t Trie::_char(int node) const {
+  HANAL_ASSERT(_format == Format::LEGACY || _format == Format::PACKED, "Nodes are not in tree form");
+  if (_format == Format::LEGACY) return _nodes[node].ch;
+  return (node == 0) ? 0 : _chars[_packed[node].code - 1];
+}
+
+
+void Trie::_build_root_jump() {
+  _root_jump.assign(Jamo::SYLLABLE_NUM, -1);
+  if (_format == Format::PACKED) {
+    const _packed_node_t& root = _packed[0];
+    int child_start = root.child & 0x7FFFFFFF;
+    for (int idx = child_start; child_start > 0 && idx < child_start + root.child_num; ++idx) {
+      wchar_t ch = _chars[_packed[idx].code - 1];
+      if (Jamo::is_syllable(ch)) _root_jump[ch - L'가'] = idx;
+    }
     return;
-  } else {
-    BOOST_LOG_TRIVIAL(trace) << "  matched: " << match_node->str(const_data());
-    if (match_node->val_idx >= 0) matches->emplace_back(len + 1, match_node->val_idx);
-    _search(text + 1, match_node, matches, len + 1);
   }
+  if (_format == Format::DAWG) {
+    int first = _dawg[0].child & 0x7FFFFFFF;
+    for (int idx = first; first > 0 && idx < first + _dawg[0].child_num; ++idx) {
+      wchar_t ch = _chars[_dawg[idx].code - 1];
+      if (Jamo::is_syllable(ch)) _root_jump[ch - L'가'] = idx;
+    }
+    return;
+  }
+
+  // both builders (trie.py and DicBuilder) write siblings sorted. only children of root are checked since they are
+  // read for jump table anyway, and checking all nodes would fault in whole mapping at open
+  const _trie_node_t& root = _nodes[0];
+  _is_sorted = true;
+  if (root.child_start <= 0 || root.child_num <= 0) return;
+  HANAL_ASSERT(root.child_start + root.child_num <= _node_num, "Invalid child of root node");
+  for (int idx = root.child_start; idx < root.child_start + root.child_num; ++idx) {
+    wchar_t ch = _nodes[idx].ch;
+    if (idx > root.child_start && _nodes[idx - 1].ch >= ch) _is_sorted = false;
+    if (Jamo::is_syllable(ch)) _root_jump[ch - L'가'] = idx;
+  }
+  if (!_is_sorted) BOOST_LOG_TRIVIAL(info) << "Siblings of trie are not sorted. linear search will be used";
+}
+
+
+int Trie::_value(int node, int weight) const {
+  if (_format == Format::DOUBLE_ARRAY) return _cells[node].val_idx;
+  if (_format == Format::LEGACY) return _nodes[node].val_idx;
+  if (_format == Format::DAWG) return (_dawg[node].child & 0x80000000) ? _dawg_values[weight] : -1;
+  if ((_packed[node].child & 0x80000000) == 0) return -1;
+  const _rank_block_t& block = _rank_blocks[node / 32];
+  return block.rank + __builtin_popcount(block.bits & ((1u << (node % 32)) - 1));
 }
 
 
@@ -11,10 +11,15 @@
 //////////////
 // includes //
 //////////////
+#include <array>
+#include <cstdint>
 #include <list>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "boost/optional.hpp"
+#include "hanal/Except.hpp"
 #include "hanal/MappedDic.hpp"
 
 
@@ -22,7 +27,7 @@ namespace hanal {
 
 
 /**
- * node of morph_trie
+ * node of morph_trie (legacy format written by trie.py in breadth first order)
  */
 struct _trie_node_t {
   wchar_t ch = 0;    ///< (wide) character
@@ -33,18 +38,166 @@ struct _trie_node_t {
 };
 
 
+/**
+ * header of trie file (except legacy format which has no header)
+ */
+struct _trie_header_t {
+  int32_t magic = 0;    ///< magic number (Trie::MAGIC)
+  int32_t format = 0;    ///< format of trie (Trie::Format)
+  int32_t alphabet_size = 0;    ///< number of characters in alphabet which follows header
+  int32_t node_num = 0;    ///< number of nodes which follows alphabet
+};
+
+
+/**
+ * cell of double-array trie. transition from cell s with character code c goes to cell t = base[s] + c
+ * if check[t] is s
+ */
+struct _da_cell_t {
+  int32_t base = 0;    ///< base of transitions
+  int32_t check = -1;    ///< parent cell. -1 for empty cell
+  int32_t val_idx = -1;    ///< index of value
+};
+
+
+/**
+ * node of packed format. nodes are in the same (breadth first) order to legacy format and siblings are sorted by
+ * code, since codes of alphabet are in order of character
+ */
+struct _packed_node_t {
+  uint16_t code = 0;    ///< remapped code of character. 0 for root
+  uint16_t child_num = 0;    ///< number of children
+  uint32_t child = 0;    ///< value flag (most significant bit) and offset to first child from this node (0 if none)
+};
+
+
+/**
+ * block of value flags of 32 packed nodes with number of values in preceding blocks. value index of a node is its
+ * rank among nodes with value (values are numbered in breadth first order)
+ */
+struct _rank_block_t {
+  uint32_t rank = 0;    ///< number of values before this block
+  uint32_t bits = 0;    ///< value flags of nodes in this block
+};
+
+
+/**
+ * transition of DAWG (minimized acyclic automaton). transitions from a state are consecutive and sorted by code, and
+ * states are shared among keys with same suffixes. first transition is a pseudo one into root state
+ */
+struct _dawg_trans_t {
+  uint16_t code = 0;    ///< remapped code of character
+  uint16_t child_num = 0;    ///< number of transitions from target state
+  uint32_t child = 0;    ///< final flag (most significant bit) and first transition from target state (0 if none)
+  int32_t weight = 0;    ///< number of keys which precede the keys through this transition in the source state
+};
+
+
+/**
+ * alphabet which remaps characters to dense codes (1 ~ alphabet size). 0 for characters not in alphabet
+ */
+class _trie_alphabet_t {
+ public:
+  /**
+   * @brief         build alphabet
+   * @param  chars  characters. code of chars[i] is i + 1
+   * @param  size   number of characters
+   */
+  void build(const int32_t* chars, int size);
+
+  void clear();    ///< clear alphabet
+
+  /**
+   * @brief      get code of character
+   * @param  ch  character
+   * @return     code. 0 if not in alphabet
+   */
+  inline int code(wchar_t ch) const {
+    auto ucs = static_cast<uint32_t>(ch);
+    if (ucs <= 0xFFFF) return _blocks[(_block_idx[ucs >> 8] << 8) | (ucs & 0xFF)];
+    return _code_ext(ch);
+  }
+
+ private:
+  std::array<int32_t, 256> _block_idx = std::array<int32_t, 256>();    ///< block index for upper 8 bits of BMP
+  std::vector<int32_t> _blocks = std::vector<int32_t>(256, 0);    ///< blocks of codes for lower 8 bits
+  std::vector<std::pair<wchar_t, int32_t>> _ext;    ///< sorted codes of characters beyond BMP
+
+  int _code_ext(wchar_t ch) const;    ///< get code of character beyond BMP
+};
+
+
+class Trie;
+
+
+/**
+ * cursor which walks down trie one character at a time. copy of cursor is a clone which walks independently.
+ * a walk from root visits the same nodes as search_common_prefix_matches(), so it gives no speedup by itself. walks
+ * from different start positions share no path, so each of them starts at root. use it to stop or resume a walk
+ */
+class TrieCursor {
+ public:
+  /**
+   * @brief        ctor. cursor is at root
+   * @param  trie  opened trie
+   */
+  explicit TrieCursor(const Trie& trie);
+
+  /**
+   * @brief      step down to child with given character
+   * @param  ch  character
+   * @return     false if no transition. the cursor becomes invalid and does not step any more
+   */
+  inline bool step(wchar_t ch);
+
+  inline bool is_valid() const;    ///< whether cursor is at a node or not
+  inline int value() const;    ///< value index at current node. -1 if no value or invalid
+  inline int depth() const;    ///< number of characters stepped so far
+  TrieCursor clone() const;    ///< clone cursor at current node
+
+ private:
+  const Trie* _trie;    ///< trie
+  int _node = 0;    ///< current node index. -1 for invalid
+  int _depth = 0;    ///< number of characters stepped
+  int _weight = 0;    ///< weight accumulated along the path
+};
+
+
 /**
  * morph_trie for wide character string
  */
-class Trie: public MappedDic<_trie_node_t> {
+class Trie {
  public:
+  static const int32_t MAGIC = 0x52544E48;    ///< magic number of header ("HNTR" in little endian)
+
+  enum class Format : int {    ///< format of trie file
+    LEGACY = 0,    ///< nodes in breadth first order without header (written by trie.py)
+    DOUBLE_ARRAY = 1,    ///< double-array
+    PACKED = 2,    ///< 8-byte nodes with remapped characters and rank of values
+    DAWG = 3,    ///< minimized acyclic automaton with weights on transitions which sum up to rank of key
+  };
+
   struct match_t {    ///< match result data structure for common prefix matches
     int len;    ///< match length
     int val_idx;    ///< value index
     explicit match_t(int len = -1, int val_idx = -1): len(len), val_idx(val_idx) {}    ///< ctor
   };
 
-  virtual void open(std::string path);
+  virtual ~Trie();    ///< dtor
+
+  /**
+   * @brief             open trie file. format is detected by header
+   * @param  path       file path
+   * @param  residency  residency options of mapped file
+   */
+  virtual void open(std::string path, const residency_t& residency = residency_t());
+
+  virtual void close();    ///< close trie file
+
+  Format format() const;    ///< format of opened trie
+
+  /** @brief  number of values if the format records it (packed and DAWG). -1 for legacy and double-array */
+  int value_num() const;
 
   /*
    * @brief        find value index with given key
@@ -74,27 +227,129 @@ class Trie: public MappedDic<_trie_node_t> {
    */
   std::list<match_t> search_common_prefix_matches(const wchar_t* text) const;
 
+  /*
+   * @brief         search all entries until longest prefix
+   * @param   text  text to search (not necessarily zero terminated)
+   * @param   len   length of text
+   * @return        collection of match results
+   */
+  std::list<match_t> search_common_prefix_matches(const wchar_t* text, int len) const;
 
- private:
   /*
-   * @brief         find value with given key start with node
-   * @param   key   key string
-   * @param   node  start node
-   * @return        value index. boost::none for non-existing key
+   * @brief             search entries until longest prefix into caller buffer without allocation
+   * @param   text      text to search (not necessarily zero terminated)
+   * @param   len       length of text
+   * @param   matches   [out] match results in order of length
+   * @param   capacity  capacity of matches. search stops when it is full
+   * @return            number of match results written
    */
-  boost::optional<int> _find(const wchar_t* key, const _trie_node_t* node) const;
+  int search_common_prefix_matches(const wchar_t* text, int len, match_t* matches, int capacity) const;
 
   /*
-   * @brief           search text until not matching
-   * @param  text     text to search
-   * @param  node     start node
-   * @param  matches  match list
-   * @param  len      length proceeded
+   * @brief            search all entries until longest prefix without allocation
+   * @param   text     text to search (not necessarily zero terminated)
+   * @param   len      length of text
+   * @param   visitor  function called with each match result (const match_t&) in order of length
+   * @return           number of match results
    */
-  void _search(const wchar_t* text, const _trie_node_t* node, std::list<match_t>* matches, int len) const;
+  template<typename V>
+  int search_common_prefix_matches(const wchar_t* text, int len, V visitor) const {
+    HANAL_ASSERT(text != nullptr, "Null text");
+    int match_num = 0;
+    int node = 0;
+    int weight = 0;
+    for (int idx = 0; idx < len && text[idx] != L'\0'; ++idx) {
+      node = _child(node, text[idx], &weight);
+      if (node < 0) break;
+      int val_idx = _value(node, weight);
+      if (val_idx < 0) continue;
+      visitor(match_t(idx + 1, val_idx));
+      ++match_num;
+    }
+    return match_num;
+  }
+
+  TrieCursor cursor() const;    ///< cursor at root
+
+ private:
+  friend class TrieCursor;
+  friend class AhoCorasick;
+
+  MappedDic<int32_t> _dic;    ///< mapped trie file
+  Format _format = Format::LEGACY;    ///< format of trie
+  const _trie_node_t* _nodes = nullptr;    ///< nodes of legacy format
+  const _da_cell_t* _cells = nullptr;    ///< cells of double-array format
+  const _packed_node_t* _packed = nullptr;    ///< nodes of packed format
+  const _rank_block_t* _rank_blocks = nullptr;    ///< value flags and ranks of packed format
+  const _dawg_trans_t* _dawg = nullptr;    ///< transitions of DAWG format
+  const int32_t* _dawg_values = nullptr;    ///< value indices of keys in lexicographic order (DAWG format)
+  const int32_t* _chars = nullptr;    ///< characters of alphabet
+  int _node_num = 0;    ///< number of nodes (or cells)
+  _trie_alphabet_t _alphabet;    ///< alphabet of double-array and packed format
+  std::vector<int32_t> _root_jump;    ///< children of root indexed by Hangul syllable (except double-array)
+  bool _is_sorted = false;    ///< whether siblings are sorted by character (legacy format. checked on root only)
+
+  /**
+   * @brief  build jump table of root (except double-array). order of siblings is checked for legacy format
+   */
+  void _build_root_jump();
+
+  /**
+   * @brief          transition to child node
+   * @param  node    node index
+   * @param  ch      character
+   * @param  weight  [in/out] weight accumulated along the path. only DAWG format needs it to get value
+   * @return         child node index. -1 if no transition
+   */
+  int _child(int node, wchar_t ch, int* weight = nullptr) const;
+
+  /**
+   * @brief         children of node for formats with consecutive children (legacy and packed)
+   * @param  node   node index
+   * @param  first  [out] index of first child
+   * @return        number of children
+   */
+  int _children(int node, int* first) const;
+
+  wchar_t _char(int node) const;    ///< character of node for legacy and packed format (0 for root)
+
+  /**
+   * @brief          value of node
+   * @param  node    node index
+   * @param  weight  weight accumulated along the path to node (DAWG format)
+   * @return         value index. -1 if no value
+   */
+  int _value(int node, int weight = 0) const;
 };
 
 
+////////////////////
+// inline methods //
+////////////////////
+bool TrieCursor::step(wchar_t ch) {
+  if (_node < 0) return false;
+  _node = _trie->_child(_node, ch, &_weight);
+  if (_node < 0) return false;
+  ++_depth;
+  return true;
+}
+
+
+bool TrieCursor::is_valid() const {
+  return _node >= 0;
+}
+
+
+int TrieCursor::value() const {
+  return (_node < 0) ? -1 : _trie->_value(_node, _weight);
+}
+
+
+int TrieCursor::depth() const {
+  return _depth;
+}
+
+
 }    // namespace hanal
 
 
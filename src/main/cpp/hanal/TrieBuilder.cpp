@@ -0,0 +1,272 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#include "hanal/TrieBuilder.hpp"
+
+
+//////////////
+// includes //
+//////////////
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "boost/functional/hash.hpp"
+#include "boost/lexical_cast.hpp"
+#include "boost/log/trivial.hpp"
+#include "hanal/Except.hpp"
+
+
+namespace hanal {
+
+
+/////////////
+// methods //
+/////////////
+void TrieBuilder::to_double_array(std::string in_path, std::string out_path) {
+  auto nodes = _read_legacy(in_path);
+  auto alphabet = _alphabet(nodes);
+  std::unordered_map<int32_t, int> codes;
+  for (int idx = 0; idx < alphabet.size(); ++idx) codes[alphabet[idx]] = idx + 1;
+
+  std::vector<_da_cell_t> cells(1);
+  cells[0].check = 0;    // root
+  std::vector<std::pair<int, int>> queue = {std::make_pair(0, 0)};    // (legacy node, cell) in breadth first order
+  int first_free = 1;    // every cell before this is used
+  std::vector<std::pair<int, int>> children;    // (code, legacy node) sorted by code
+  for (int qdx = 0; qdx < queue.size(); ++qdx) {
+    int node_idx = queue[qdx].first;
+    int cell_idx = queue[qdx].second;
+    const _trie_node_t& node = nodes[node_idx];
+    cells[cell_idx].val_idx = node.val_idx;
+    if (node.child_start <= 0 || node.child_num <= 0) continue;
+    children.clear();
+    for (int child_idx = node_idx + node.child_start; child_idx < node_idx + node.child_start + node.child_num;
+         ++child_idx) {
+      children.emplace_back(codes[nodes[child_idx].ch], child_idx);
+    }
+    std::sort(children.begin(), children.end());
+
+    // find base whose transition cells are all empty, starting from first empty cell
+    int base = 0;
+    for (int pos = first_free; ; ++pos) {
+      while (pos < cells.size() && cells[pos].check >= 0) pos += 1;
+      base = pos - children.front().first;
+      if (base < 0) continue;
+      bool is_empty = true;
+      for (auto& child : children) {
+        int next = base + child.first;
+        if (next < cells.size() && cells[next].check >= 0) {
+          is_empty = false;
+          break;
+        }
+      }
+      if (is_empty) break;
+    }
+    if (cells.size() <= base + children.back().first) cells.resize(base + children.back().first + 1);
+    cells[cell_idx].base = base;
+    for (auto& child : children) {
+      cells[base + child.first].check = cell_idx;
+      queue.emplace_back(child.second, base + child.first);
+    }
+    while (first_free < cells.size() && cells[first_free].check >= 0) first_free += 1;
+  }
+  BOOST_LOG_TRIVIAL(info) << "Double-array trie: " << nodes.size() << " nodes into " << cells.size() << " cells";
+  _write(out_path, Trie::Format::DOUBLE_ARRAY, alphabet, cells);
+}
+
+
+void TrieBuilder::to_packed(std::string in_path, std::string out_path) {
+  static_assert(sizeof(_packed_node_t) == 8, "Invalid size of packed node");
+  auto nodes = _read_legacy(in_path);
+  std::map<int32_t, int> codes;
+  auto alphabet = _sorted_alphabet(nodes, &codes);
+
+  std::vector<_packed_node_t> packed(nodes.size());
+  std::vector<_rank_block_t> blocks((nodes.size() + 31) / 32);
+  int val_num = 0;
+  for (int idx = 0; idx < nodes.size(); ++idx) {
+    const _trie_node_t& node = nodes[idx];
+    if (idx % 32 == 0) blocks[idx / 32].rank = val_num;
+    if (idx > 0) packed[idx].code = codes[node.ch];
+    if (node.child_start > 0 && node.child_num > 0) {
+      packed[idx].child_num = node.child_num;
+      packed[idx].child = node.child_start;
+    }
+    if (node.val_idx >= 0) {
+      HANAL_ASSERT(node.val_idx == val_num,
+                   "Values are not numbered in breadth first order at node: " + boost::lexical_cast<std::string>(idx));
+      packed[idx].child |= 0x80000000;
+      blocks[idx / 32].bits |= 1u << (idx % 32);
+      val_num += 1;
+    }
+  }
+  BOOST_LOG_TRIVIAL(info) << "Packed trie: " << nodes.size() << " nodes with " << alphabet.size() << " characters";
+  _write(out_path, Trie::Format::PACKED, alphabet, packed);
+  _append(out_path, blocks);
+}
+
+
+void TrieBuilder::to_dawg(std::string in_path, std::string out_path) {
+  auto nodes = _read_legacy(in_path);
+  std::map<int32_t, int> codes;
+  auto alphabet = _sorted_alphabet(nodes, &codes);
+
+  // merge nodes with same finality and same transitions into a state from leaves (nodes are in breadth first order)
+  std::vector<int> state_of(nodes.size());
+  std::vector<int> key_nums(nodes.size(), 0);    // number of keys under each node
+  std::vector<int> repr_nodes;    // representative node of each state
+  std::unordered_map<std::vector<int32_t>, int, boost::hash<std::vector<int32_t>>> states;
+  std::vector<int32_t> signature;    // (final, (code, state) of children...)
+  for (int idx = nodes.size() - 1; idx >= 0; --idx) {
+    const _trie_node_t& node = nodes[idx];
+    signature.assign(1, node.val_idx >= 0 ? 1 : 0);
+    key_nums[idx] = signature[0];
+    for (int child_idx = idx + node.child_start; node.child_start > 0 && child_idx < idx + node.child_start
+         + node.child_num; ++child_idx) {
+      signature.emplace_back(codes[nodes[child_idx].ch]);
+      signature.emplace_back(state_of[child_idx]);
+      key_nums[idx] += key_nums[child_idx];
+    }
+    auto inserted = states.emplace(signature, repr_nodes.size());
+    if (inserted.second) repr_nodes.emplace_back(idx);
+    state_of[idx] = inserted.first->second;
+  }
+
+  // lay out transitions of each state consecutively in breadth first order of states
+  std::vector<_dawg_trans_t> trans(1);    // first one is pseudo transition into root
+  std::vector<int> targets = {state_of[0]};    // target state of each transition
+  std::vector<int> first_trans(repr_nodes.size(), 0);    // first transition from each state. 0 for no transition
+  std::vector<bool> is_laid_out(repr_nodes.size(), false);
+  for (int tdx = 0; tdx < targets.size(); ++tdx) {
+    int state = targets[tdx];
+    if (is_laid_out[state]) continue;
+    is_laid_out[state] = true;
+    int idx = repr_nodes[state];
+    const _trie_node_t& node = nodes[idx];
+    if (node.child_start <= 0 || node.child_num <= 0) continue;
+    first_trans[state] = trans.size();
+    int weight = (node.val_idx >= 0) ? 1 : 0;
+    for (int child_idx = idx + node.child_start; child_idx < idx + node.child_start + node.child_num; ++child_idx) {
+      _dawg_trans_t tran;
+      tran.code = codes[nodes[child_idx].ch];
+      tran.weight = weight;
+      weight += key_nums[child_idx];
+      trans.emplace_back(tran);
+      targets.emplace_back(state_of[child_idx]);
+    }
+  }
+  for (int tdx = 0; tdx < trans.size(); ++tdx) {
+    const _trie_node_t& node = nodes[repr_nodes[targets[tdx]]];
+    if (node.child_start > 0 && node.child_num > 0) {
+      trans[tdx].child_num = node.child_num;
+      trans[tdx].child = first_trans[targets[tdx]];
+    }
+    if (node.val_idx >= 0) trans[tdx].child |= 0x80000000;
+  }
+
+  // values of keys in lexicographic order (preorder of depth first traversal)
+  std::vector<int32_t> values;
+  std::vector<int> stack = {0};
+  while (!stack.empty()) {
+    const _trie_node_t& node = nodes[stack.back()];
+    int idx = stack.back();
+    stack.pop_back();
+    if (node.val_idx >= 0) values.emplace_back(node.val_idx);
+    for (int child_idx = idx + node.child_start + node.child_num - 1; node.child_start > 0
+         && child_idx >= idx + node.child_start; --child_idx) {
+      stack.emplace_back(child_idx);
+    }
+  }
+  HANAL_ASSERT(values.size() == key_nums[0], "Invalid number of values: " + in_path);
+
+  BOOST_LOG_TRIVIAL(info) << "DAWG: " << nodes.size() << " nodes into " << repr_nodes.size() << " states with "
+                          << trans.size() << " transitions";
+  _write(out_path, Trie::Format::DAWG, alphabet, trans);
+  _append(out_path, std::vector<int32_t>(1, values.size()));
+  _append(out_path, values);
+}
+
+
+std::vector<_trie_node_t> TrieBuilder::_read_legacy(std::string path) {
+  std::ifstream fin(path, std::ios::binary);
+  HANAL_ASSERT(fin.good(), "Fail to open file: " + path);
+  std::vector<_trie_node_t> nodes;
+  _trie_node_t node;
+  while (fin.read(reinterpret_cast<char*>(&node), sizeof(node))) nodes.emplace_back(node);
+  HANAL_ASSERT(nodes.size() > 0 && nodes[0].ch == 0, "Invalid legacy trie file: " + path);
+  return nodes;
+}
+
+
+std::vector<int32_t> TrieBuilder::_alphabet(const std::vector<_trie_node_t>& nodes) {
+  std::map<int32_t, int> freqs;
+  for (int idx = 1; idx < nodes.size(); ++idx) freqs[nodes[idx].ch] += 1;
+  std::vector<std::pair<int, int32_t>> freq_chars;
+  for (auto& freq : freqs) freq_chars.emplace_back(-freq.second, freq.first);
+  std::sort(freq_chars.begin(), freq_chars.end());
+  std::vector<int32_t> alphabet;
+  for (auto& freq_char : freq_chars) alphabet.emplace_back(freq_char.second);
+  return alphabet;
+}
+
+
+std::vector<int32_t> TrieBuilder::_sorted_alphabet(const std::vector<_trie_node_t>& nodes,
+                                                   std::map<int32_t, int>* codes) {
+  codes->clear();
+  for (int idx = 0; idx < nodes.size(); ++idx) {
+    const _trie_node_t& node = nodes[idx];
+    if (idx > 0) (*codes)[node.ch] = 0;
+    if (node.child_start <= 0 || node.child_num <= 0) continue;
+    HANAL_ASSERT(node.child_num <= 0xFFFF && idx + node.child_start + node.child_num <= nodes.size(),
+                 "Invalid child of node: " + boost::lexical_cast<std::string>(idx));
+    for (int child_idx = idx + node.child_start + 1; child_idx < idx + node.child_start + node.child_num;
+         ++child_idx) {
+      HANAL_ASSERT(nodes[child_idx - 1].ch < nodes[child_idx].ch,
+                   "Siblings are not sorted at node: " + boost::lexical_cast<std::string>(idx));
+    }
+  }
+  HANAL_ASSERT(codes->size() <= 0xFFFF, "Too many characters in alphabet");
+  std::vector<int32_t> alphabet;
+  for (auto& code : *codes) {
+    alphabet.emplace_back(code.first);
+    code.second = alphabet.size();
+  }
+  return alphabet;
+}
+
+
+template<typename T>
+void TrieBuilder::_write(std::string path, Trie::Format format, const std::vector<int32_t>& alphabet,
+                         const std::vector<T>& nodes) {
+  std::ofstream fout(path, std::ios::binary);
+  HANAL_ASSERT(fout.good(), "Fail to open file: " + path);
+  _trie_header_t header;
+  header.magic = Trie::MAGIC;
+  header.format = static_cast<int32_t>(format);
+  header.alphabet_size = alphabet.size();
+  header.node_num = nodes.size();
+  fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  fout.write(reinterpret_cast<const char*>(alphabet.data()), alphabet.size() * sizeof(int32_t));
+  fout.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(T));
+  HANAL_ASSERT(fout.good(), "Fail to write file: " + path);
+}
+
+
+template<typename T>
+void TrieBuilder::_append(std::string path, const std::vector<T>& blocks) {
+  std::ofstream fout(path, std::ios::binary | std::ios::app);
+  HANAL_ASSERT(fout.good(), "Fail to open file: " + path);
+  fout.write(reinterpret_cast<const char*>(blocks.data()), blocks.size() * sizeof(T));
+  HANAL_ASSERT(fout.good(), "Fail to write file: " + path);
+}
+
+
+}    // namespace hanal
@@ -0,0 +1,99 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#ifndef HANAL_TRIEBUILDER_HPP
+#define HANAL_TRIEBUILDER_HPP
+
+
+//////////////
+// includes //
+//////////////
+#include <map>
+#include <string>
+#include <vector>
+
+#include "hanal/Trie.hpp"
+
+
+namespace hanal {
+
+
+/**
+ * converter of legacy trie files (written by trie.py) into other formats
+ */
+class TrieBuilder {
+ public:
+  /**
+   * @brief            convert legacy trie file into double-array format
+   * @param  in_path   legacy trie file
+   * @param  out_path  double-array trie file
+   */
+  static void to_double_array(std::string in_path, std::string out_path);
+
+  /**
+   * @brief            convert legacy trie file into packed format
+   * @param  in_path   legacy trie file (siblings sorted by character and values numbered in breadth first order)
+   * @param  out_path  packed trie file
+   */
+  static void to_packed(std::string in_path, std::string out_path);
+
+  /**
+   * @brief            convert legacy trie file into DAWG format
+   * @param  in_path   legacy trie file (siblings sorted by character)
+   * @param  out_path  DAWG file
+   */
+  static void to_dawg(std::string in_path, std::string out_path);
+
+ private:
+  /**
+   * @brief        read nodes of legacy trie file
+   * @param  path  file path
+   * @return       nodes
+   */
+  static std::vector<_trie_node_t> _read_legacy(std::string path);
+
+  /**
+   * @brief         alphabet of trie sorted by frequency (frequent characters get small codes)
+   * @param  nodes  nodes of legacy trie
+   * @return        characters of alphabet
+   */
+  static std::vector<int32_t> _alphabet(const std::vector<_trie_node_t>& nodes);
+
+  /**
+   * @brief         alphabet of trie sorted by character, which keeps order of siblings. siblings are checked to be
+   *                sorted by character
+   * @param  nodes  nodes of legacy trie
+   * @param  codes  [out] code of each character (1 ~ alphabet size)
+   * @return        characters of alphabet
+   */
+  static std::vector<int32_t> _sorted_alphabet(const std::vector<_trie_node_t>& nodes,
+                                               std::map<int32_t, int>* codes);
+
+  /**
+   * @brief            write trie file
+   * @param  path      file path
+   * @param  format    trie format
+   * @param  alphabet  characters of alphabet
+   * @param  nodes     nodes
+   */
+  template<typename T>
+  static void _write(std::string path, Trie::Format format, const std::vector<int32_t>& alphabet,
+                     const std::vector<T>& nodes);
+
+  /**
+   * @brief          append data to trie file written by _write()
+   * @param  path    file path
+   * @param  blocks  data to append
+   */
+  template<typename T>
+  static void _append(std::string path, const std::vector<T>& blocks);
+};
+
+
+}    // namespace hanal
+
+
+#endif  // HANAL_TRIEBUILDER_HPP
@@ -0,0 +1,317 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#include "hanal/Utf8.hpp"
+
+
+//////////////
+// includes //
+//////////////
+#include <cstdint>
+#include <cwchar>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) && WCHAR_MAX > 0xFFFF
+#define HANAL_UTF8_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(HANAL_UTF8_SSE2) && defined(__AVX2__)
+#define HANAL_UTF8_AVX2
+#include <immintrin.h>
+#endif
+
+#include "boost/lexical_cast.hpp"
+#include "hanal/Except.hpp"
+
+
+namespace hanal {
+
+
+///////////////
+// functions //
+///////////////
+#ifdef HANAL_UTF8_SSE2
+/**
+ * @brief             widen 16 ASCII bytes to wide characters and write their offsets
+ * @param  block      16 bytes block
+ * @param  pos        byte offset of the block
+ * @param  wchar_out  [out] wide characters
+ * @param  offset_out [out] offsets
+ */
+static inline void _widen_ascii16(__m128i block, int pos, wchar_t* wchar_out, int* offset_out) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i lo = _mm_unpacklo_epi8(block, zero);
+  __m128i hi = _mm_unpackhi_epi8(block, zero);
+  __m128i* wchar_vec = reinterpret_cast<__m128i*>(wchar_out);
+  _mm_storeu_si128(wchar_vec, _mm_unpacklo_epi16(lo, zero));
+  _mm_storeu_si128(wchar_vec + 1, _mm_unpackhi_epi16(lo, zero));
+  _mm_storeu_si128(wchar_vec + 2, _mm_unpacklo_epi16(hi, zero));
+  _mm_storeu_si128(wchar_vec + 3, _mm_unpackhi_epi16(hi, zero));
+  const __m128i four = _mm_set1_epi32(4);
+  __m128i offset = _mm_add_epi32(_mm_set1_epi32(pos), _mm_setr_epi32(0, 1, 2, 3));
+  __m128i* offset_vec = reinterpret_cast<__m128i*>(offset_out);
+  for (int i = 0; i < 4; ++i) {
+    _mm_storeu_si128(offset_vec + i, offset);
+    offset = _mm_add_epi32(offset, four);
+  }
+}
+
+
+/**
+ * @brief         whether first 12 bytes of block are four 3-byte sequences (lead byte and two continuation bytes)
+ * @param  block  16 bytes block
+ * @return        true if matched
+ */
+static inline bool _is_3byte_x4(__m128i block) {
+  alignas(16) static const uint8_t _MASK[16] = {
+      0xF0, 0xC0, 0xC0, 0xF0, 0xC0, 0xC0, 0xF0, 0xC0, 0xC0, 0xF0, 0xC0, 0xC0, 0x00, 0x00, 0x00, 0x00
+  };
+  alignas(16) static const uint8_t _EXPECT[16] = {
+      0xE0, 0x80, 0x80, 0xE0, 0x80, 0x80, 0xE0, 0x80, 0x80, 0xE0, 0x80, 0x80, 0x00, 0x00, 0x00, 0x00
+  };
+  __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(_MASK));
+  __m128i expect = _mm_load_si128(reinterpret_cast<const __m128i*>(_EXPECT));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(block, mask), expect)) == 0xFFFF;
+}
+
+
+/**
+ * @brief         bit mask of ASCII white space bytes (space, \t, \n, \v, \r) in block
+ * @param  block  16 bytes block
+ * @return        bit mask
+ */
+static inline int _ascii_space_mask(__m128i block) {
+  __m128i space = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+  space = _mm_or_si128(space, _mm_cmpeq_epi8(block, _mm_set1_epi8('\t')));
+  space = _mm_or_si128(space, _mm_cmpeq_epi8(block, _mm_set1_epi8('\n')));
+  space = _mm_or_si128(space, _mm_cmpeq_epi8(block, _mm_set1_epi8('\v')));
+  space = _mm_or_si128(space, _mm_cmpeq_epi8(block, _mm_set1_epi8('\r')));
+  return _mm_movemask_epi8(space);
+}
+
+
+/**
+ * @brief        bit mask of start positions of ideographic space (U+3000, E3 80 80) in 16 bytes
+ * @param  text  start of bytes. 18 bytes must be readable
+ * @return       bit mask
+ */
+static inline int _ideographic_space_mask(const uint8_t* text) {
+  __m128i lead = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+  __m128i cont1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 1));
+  __m128i cont2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 2));
+  __m128i match = _mm_cmpeq_epi8(lead, _mm_set1_epi8(static_cast<char>(0xE3)));
+  match = _mm_and_si128(match, _mm_cmpeq_epi8(cont1, _mm_set1_epi8(static_cast<char>(0x80))));
+  match = _mm_and_si128(match, _mm_cmpeq_epi8(cont2, _mm_set1_epi8(static_cast<char>(0x80))));
+  return _mm_movemask_epi8(match);
+}
+#endif
+
+
+/**
+ * @brief        length of white space at the position
+ * @param  text  text
+ * @param  pos   position
+ * @param  len   length of text
+ * @return       byte length of white space. 0 if not white space
+ */
+static inline int _space_len(const uint8_t* text, int pos, int len) {
+  switch (text[pos]) {
+    case ' ': case '\t': case '\n': case '\v': case '\r':
+      return 1;
+    case 0xE3:
+      return (pos + 2 < len && text[pos + 1] == 0x80 && text[pos + 2] == 0x80) ? 3 : 0;
+    default:
+      return 0;
+  }
+}
+
+
+#ifdef HANAL_UTF8_AVX2
+/**
+ * @brief             widen 32 ASCII bytes to wide characters and write their offsets
+ * @param  text       start of 32 bytes
+ * @param  pos        byte offset of the block
+ * @param  wchar_out  [out] wide characters
+ * @param  offset_out [out] offsets
+ */
+static inline void _widen_ascii32(const uint8_t* text, int pos, wchar_t* wchar_out, int* offset_out) {
+  const __m256i eight = _mm256_set1_epi32(8);
+  __m256i offset = _mm256_add_epi32(_mm256_set1_epi32(pos), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+  for (int i = 0; i < 4; ++i) {
+    __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(text + i * 8));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(wchar_out + i * 8), _mm256_cvtepu8_epi32(bytes));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(offset_out + i * 8), offset);
+    offset = _mm256_add_epi32(offset, eight);
+  }
+}
+#endif
+
+
+/////////////
+// methods //
+/////////////
+void Utf8::decode(const char* begin, const char* end, std::vector<wchar_t>* wchars, std::vector<int>* offsets,
+                  int offset_base) {
+  HANAL_ASSERT(begin != nullptr && begin <= end, "Invalid text to decode");
+  HANAL_ASSERT(wchars != nullptr && offsets != nullptr && wchars->size() == offsets->size(), "Invalid output");
+  auto text = reinterpret_cast<const uint8_t*>(begin);
+  int len = end - begin;
+  size_t prev_size = wchars->size();
+  wchars->resize(prev_size + len);    // number of characters can't exceed number of bytes
+  offsets->resize(prev_size + len);
+  wchar_t* wchar_out = wchars->data() + prev_size;
+  int* offset_out = offsets->data() + prev_size;
+  int num = 0;    // number of decoded characters
+  int pos = 0;
+  while (pos < len) {
+#ifdef HANAL_UTF8_AVX2
+    // since num <= pos, writing 32 elements at num is safe when 32 bytes remain
+    while (pos + 32 <= len
+           && _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + pos))) == 0) {
+      _widen_ascii32(text + pos, offset_base + pos, wchar_out + num, offset_out + num);
+      num += 32;
+      pos += 32;
+    }
+#endif
+#ifdef HANAL_UTF8_SSE2
+    if (pos + 16 <= len) {
+      __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + pos));
+      int non_ascii = _mm_movemask_epi8(block);
+      if (non_ascii != 0xFFFF) {
+        // leading ASCII characters. the rest of 16 elements are overwritten by following characters
+        int ascii_len = (non_ascii == 0) ? 16 : __builtin_ctz(non_ascii);
+        if (ascii_len > 0) {
+          _widen_ascii16(block, offset_base + pos, wchar_out + num, offset_out + num);
+          num += ascii_len;
+          pos += ascii_len;
+          continue;
+        }
+      }
+      if (_is_3byte_x4(block)) {
+        // four 3-byte characters (mostly Hangul syllables)
+        uint32_t codes[4];
+        bool is_valid = true;
+        for (int i = 0; i < 4; ++i) {
+          const uint8_t* seq = text + pos + i * 3;
+          codes[i] = ((seq[0] & 0x0Fu) << 12) | ((seq[1] & 0x3Fu) << 6) | (seq[2] & 0x3Fu);
+          is_valid &= codes[i] >= 0x800 && (codes[i] < 0xD800 || codes[i] > 0xDFFF);
+        }
+        if (is_valid) {
+          for (int i = 0; i < 4; ++i) {
+            wchar_out[num] = static_cast<wchar_t>(codes[i]);
+            offset_out[num] = offset_base + pos;
+            num += 1;
+            pos += 3;
+          }
+          continue;
+        }
+      }
+    }
+#endif
+    int char_len = decode_char(begin + pos, end, wchar_out + num);
+    HANAL_ASSERT(char_len > 0, "Fail to convert character at position: " + boost::lexical_cast<std::string>(pos));
+    offset_out[num] = offset_base + pos;
+    num += 1;
+    pos += char_len;
+  }
+  wchars->resize(prev_size + num);
+  offsets->resize(prev_size + num);
+}
+
+
+void Utf8::scan_words(const char* begin, const char* end, std::vector<span_t>* spans) {
+  HANAL_ASSERT(begin != nullptr && begin <= end, "Invalid text to scan");
+  HANAL_ASSERT(spans != nullptr, "Invalid output");
+  spans->clear();
+  auto text = reinterpret_cast<const uint8_t*>(begin);
+  int len = end - begin;
+  int word_begin = -1;    // start of current word. -1 if in white spaces
+  int pos = 0;
+#ifdef HANAL_UTF8_SSE2
+  uint32_t carry = 0;    // trailing bytes of ideographic space which started in previous block
+  for (; pos + 18 <= len; pos += 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + pos));
+    uint32_t ideographic = _ideographic_space_mask(text + pos);
+    ideographic |= (ideographic << 1) | (ideographic << 2);
+    uint32_t space = _ascii_space_mask(block) | ideographic | carry;
+    carry = ideographic >> 16;
+    space &= 0xFFFF;
+    // nothing changed in this block
+    if ((space == 0 && word_begin >= 0) || (space == 0xFFFF && word_begin < 0)) continue;
+    // bit is set at each position where space-ness differs from the previous byte
+    uint32_t prev_space = (space << 1) | (word_begin < 0 ? 1 : 0);
+    uint32_t changes = (space ^ prev_space) & 0xFFFF;
+    while (changes != 0) {
+      int change_pos = pos + __builtin_ctz(changes);
+      if (word_begin < 0) {
+        word_begin = change_pos;
+      } else {
+        spans->emplace_back(word_begin, change_pos);
+        word_begin = -1;
+      }
+      changes &= changes - 1;
+    }
+  }
+  // skip trailing bytes of ideographic space crossing block boundary
+  for (; carry != 0; carry >>= 1) pos += 1;
+#endif
+  while (pos < len) {
+    int space_len = _space_len(text, pos, len);
+    if (space_len > 0) {
+      if (word_begin >= 0) {
+        spans->emplace_back(word_begin, pos);
+        word_begin = -1;
+      }
+      pos += space_len;
+    } else {
+      if (word_begin < 0) word_begin = pos;
+      pos += 1;
+    }
+  }
+  if (word_begin >= 0) spans->emplace_back(word_begin, len);
+}
+
+
+int Utf8::decode_char(const char* begin, const char* end, wchar_t* wchar) {
+  auto text = reinterpret_cast<const uint8_t*>(begin);
+  int len = end - begin;
+  if (len <= 0) return 0;
+  uint32_t lead = text[0];
+  if (lead < 0x80) {
+    *wchar = static_cast<wchar_t>(lead);
+    return 1;
+  }
+  int size = 0;
+  uint32_t code = 0;
+  uint32_t min_code = 0;    // minimum code to reject overlong sequence
+  if ((lead & 0xE0) == 0xC0) {
+    size = 2;
+    code = lead & 0x1F;
+    min_code = 0x80;
+  } else if ((lead & 0xF0) == 0xE0) {
+    size = 3;
+    code = lead & 0x0F;
+    min_code = 0x800;
+  } else if ((lead & 0xF8) == 0xF0) {
+    size = 4;
+    code = lead & 0x07;
+    min_code = 0x10000;
+  } else {
+    return 0;
+  }
+  if (len < size) return 0;
+  for (int i = 1; i < size; ++i) {
+    if ((text[i] & 0xC0) != 0x80) return 0;
+    code = (code << 6) | (text[i] & 0x3F);
+  }
+  if (code < min_code || code > 0x10FFFF || (0xD800 <= code && code <= 0xDFFF)) return 0;
+  *wchar = static_cast<wchar_t>(code);
+  return size;
+}
+
+
+}    // namespace hanal
@@ -0,0 +1,64 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#ifndef HANAL_UTF8_HPP
+#define HANAL_UTF8_HPP
+
+
+//////////////
+// includes //
+//////////////
+#include <vector>
+
+
+namespace hanal {
+
+
+/**
+ * locale independent UTF-8 decoder
+ */
+class Utf8 {
+ public:
+  struct span_t {    ///< span of bytes
+    int begin;    ///< start position (byte offset, inclusive)
+    int end;    ///< end position (byte offset, exclusive)
+    explicit span_t(int begin = -1, int end = -1): begin(begin), end(end) {}    ///< ctor
+  };
+
+  /**
+   * @brief               decode UTF-8 text into wide characters (append to output vectors)
+   * @param  begin        start of text
+   * @param  end          end of text (exclusive)
+   * @param  wchars       [out] decoded wide characters
+   * @param  offsets      [out] start position (byte offset from begin plus offset_base) of each character
+   * @param  offset_base  base value added to offsets
+   */
+  static void decode(const char* begin, const char* end, std::vector<wchar_t>* wchars, std::vector<int>* offsets,
+                     int offset_base = 0);
+
+  /**
+   * @brief         find words separated by white spaces (same to Char::SPACE) without decoding
+   * @param  begin  start of text
+   * @param  end    end of text (exclusive)
+   * @param  spans  [out] byte spans of words (offset from begin). previous spans are cleared
+   */
+  static void scan_words(const char* begin, const char* end, std::vector<span_t>* spans);
+
+  /**
+   * @brief          decode single UTF-8 character
+   * @param  begin   start of character
+   * @param  end     end of text (exclusive)
+   * @param  wchar   [out] decoded wide character
+   * @return         number of bytes of the character. 0 for invalid (or truncated) sequence
+   */
+  static int decode_char(const char* begin, const char* end, wchar_t* wchar);
+};
+
+
+}    // namespace hanal
+
+
+#endif  // HANAL_UTF8_HPP
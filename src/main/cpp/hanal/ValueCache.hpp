@@ -0,0 +1,254 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+#ifndef HANAL_VALUECACHE_HPP
+#define HANAL_VALUECACHE_HPP
+
+
+//////////////
+// includes //
+//////////////
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>    // NOLINT
+#include <thread>    // NOLINT
+#include <utility>
+#include <vector>
+
+
+namespace hanal {
+
+
+/**
+ * options of value cache
+ */
+struct cache_option_t {
+  size_t budget = 0;    ///< budget of (estimated) heap bytes of cached values. 0 for unbounded
+  int warm_up = 0;    ///< number of values loaded at open from the first one (the most frequent after layout)
+};
+
+
+/**
+ * statistics of value cache
+ */
+struct cache_stat_t {
+  uint64_t hits = 0;    ///< number of hits
+  uint64_t misses = 0;    ///< number of misses (loads)
+  uint64_t evictions = 0;    ///< number of evictions
+  size_t bytes = 0;    ///< (estimated) heap bytes of cached values
+};
+
+
+/**
+ * cache of values indexed by slot which is shared among threads. hits take no lock: without budget, a reader just
+ * loads holder of the slot and gets plain pointer of the value since it is never freed until close. with budget, a
+ * reader pins the slot, copies shared pointer of the value and unpins it. a value is loaded once by the thread which
+ * claims its empty slot. with byte budget, values are evicted by CLOCK (second chance) algorithm on misses, and evicted
+ * values stay alive while readers hold them. hits are counted in per-thread shards, so they share no cache line
+ */
+template<typename T>
+class ValueCache {
+ public:
+  /**
+   * reference of cached value. without budget, it only points to value. with budget, it also owns value (shared with
+   * cache), so evicted value is alive while reference is held
+   */
+  class ref_t {
+   public:
+    const T* get() const { return _ptr; }    ///< pointer of value
+    const T& operator*() const { return *_ptr; }    ///< value
+    const T* operator->() const { return _ptr; }    ///< pointer of value
+
+   private:
+    friend class ValueCache;
+
+    const T* _ptr = nullptr;    ///< value
+    std::shared_ptr<const T> _owner;    ///< owner of value. empty without budget
+
+    explicit ref_t(const T* ptr, std::shared_ptr<const T> owner = nullptr) : _ptr(ptr), _owner(std::move(owner)) {}
+  };
+
+  virtual ~ValueCache() {
+    close();
+  }
+
+  /**
+   * @brief         open empty cache
+   * @param  size   number of slots
+   * @param  budget budget of heap bytes. 0 for unbounded
+   */
+  void open(int size, size_t budget) {
+    close();
+    _size = size;
+    _budget = budget;
+    _slots.reset(new _slot_t[size]);
+  }
+
+  /**
+   * @brief  close cache and release values
+   */
+  void close() {
+    for (int idx = 0; idx < _size; ++idx) {
+      auto holder = _slots[idx].holder.load();
+      if (holder != &_LOADING) delete holder;
+    }
+    _slots.reset();
+    _size = 0;
+    _ring.clear();
+    _hand = 0;
+    for (auto& shard : _hit_shards) shard.hits = 0;
+    _misses = 0;
+    _evictions = 0;
+    _bytes = 0;
+  }
+
+  /**
+   * @brief       get value. loaded on miss
+   * @param  idx  slot index
+   * @param  load function to load value which returns (value, estimated heap bytes)
+   * @return      reference of value
+   */
+  template<typename L>
+  ref_t get(int idx, L load) {
+    _slot_t& slot = _slots[idx];
+    if (_budget == 0) {    // values are never evicted, so holder is read without pinning slot nor copying owner
+      auto holder = slot.holder.load(std::memory_order_acquire);
+      if (holder != nullptr && holder != &_LOADING) {
+        _hit();
+        return ref_t(holder->get());
+      }
+    }
+    for (;;) {
+      slot.pins.fetch_add(1);
+      auto holder = slot.holder.load();
+      if (holder != nullptr && holder != &_LOADING) {
+        ref_t value(holder->get(), *holder);
+        slot.pins.fetch_sub(1);
+        if (!slot.referenced.load(std::memory_order_relaxed)) slot.referenced.store(true, std::memory_order_relaxed);
+        _hit();
+        return value;
+      }
+      slot.pins.fetch_sub(1);
+      if (holder == &_LOADING) {
+        std::this_thread::yield();    // the other thread is loading
+        continue;
+      }
+      if (slot.holder.compare_exchange_strong(holder, &_LOADING)) break;
+    }
+
+    _misses.fetch_add(1, std::memory_order_relaxed);
+    std::pair<T, size_t> loaded;
+    try {
+      loaded = load(idx);
+    } catch (...) {
+      slot.holder.store(nullptr);
+      throw;
+    }
+    auto value = std::make_shared<const T>(std::move(loaded.first));
+    slot.bytes = loaded.second;
+    slot.referenced.store(true, std::memory_order_relaxed);
+    if (_budget == 0) {
+      _bytes.fetch_add(slot.bytes, std::memory_order_relaxed);
+      slot.holder.store(new std::shared_ptr<const T>(value));
+      return ref_t(value.get());
+    }
+    std::lock_guard<std::mutex> lock(_ring_mutex);
+    _bytes.fetch_add(slot.bytes, std::memory_order_relaxed);
+    _evict();
+    _ring.emplace_back(idx);
+    slot.holder.store(new std::shared_ptr<const T>(value));
+    return ref_t(value.get(), value);
+  }
+
+  /**
+   * @brief   statistics
+   */
+  cache_stat_t stat() const {
+    cache_stat_t stat;
+    for (auto& shard : _hit_shards) stat.hits += shard.hits.load(std::memory_order_relaxed);
+    stat.misses = _misses.load();
+    stat.evictions = _evictions.load();
+    stat.bytes = _bytes.load();
+    return stat;
+  }
+
+ private:
+  struct _slot_t {    ///< slot of a value
+    std::atomic<const std::shared_ptr<const T>*> holder{nullptr};    ///< holder of value. nullptr for empty slot
+    std::atomic<int> pins{0};    ///< number of readers copying value from holder
+    std::atomic<bool> referenced{false};    ///< reference bit of CLOCK
+    size_t bytes = 0;    ///< heap bytes of value
+  };
+
+  struct _hit_shard_t {    ///< shard of hit counter padded to its own cache line
+    std::atomic<uint64_t> hits{0};    ///< number of hits
+    char padding[64 - sizeof(std::atomic<uint64_t>)];    ///< padding
+  };
+
+  static const std::shared_ptr<const T> _LOADING;    ///< sentinel holder of slot which is being loaded
+  static const int _HIT_SHARD_NUM = 64;    ///< number of shards of hit counter
+
+  int _size = 0;    ///< number of slots
+  size_t _budget = 0;    ///< budget of heap bytes
+  std::unique_ptr<_slot_t[]> _slots;    ///< slots
+  std::mutex _ring_mutex;    ///< mutex of ring and hand (taken only on misses with budget)
+  std::vector<int> _ring;    ///< slots of cached values in CLOCK
+  size_t _hand = 0;    ///< hand of CLOCK
+  std::array<_hit_shard_t, _HIT_SHARD_NUM> _hit_shards;    ///< shards of hit counter
+  std::atomic<uint64_t> _misses{0};    ///< number of misses
+  std::atomic<uint64_t> _evictions{0};    ///< number of evictions
+  std::atomic<size_t> _bytes{0};    ///< heap bytes of cached values
+
+  /**
+   * @brief  count a hit in shard of current thread. threads get shards in turn at their first hit
+   */
+  void _hit() {
+    static std::atomic<int> next_shard{0};
+    static thread_local int shard = next_shard.fetch_add(1, std::memory_order_relaxed) % _HIT_SHARD_NUM;
+    _hit_shards[shard].hits.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief  evict values until heap bytes are within budget. values recently referenced get a second chance.
+   *         ring mutex must be held
+   */
+  void _evict() {
+    while (_bytes.load() > _budget && !_ring.empty()) {
+      if (_hand >= _ring.size()) _hand = 0;
+      _slot_t& slot = _slots[_ring[_hand]];
+      if (slot.referenced.exchange(false)) {
+        _hand += 1;
+        continue;
+      }
+      size_t bytes = slot.bytes;    // read before slot is emptied and claimed by the other thread
+      auto holder = slot.holder.exchange(nullptr);
+      while (slot.pins.load() > 0) std::this_thread::yield();    // readers copying value
+      delete holder;
+      _bytes.fetch_sub(bytes);
+      _evictions.fetch_add(1, std::memory_order_relaxed);
+      _ring[_hand] = _ring.back();
+      _ring.pop_back();
+    }
+  }
+};
+
+
+////////////////////
+// static members //
+////////////////////
+template<typename T>
+const std::shared_ptr<const T> ValueCache<T>::_LOADING;
+template<typename T>
+const int ValueCache<T>::_HIT_SHARD_NUM;
+
+
+}    // namespace hanal
+
+
+#endif  // HANAL_VALUECACHE_HPP
@@ -15,8 +15,8 @@
 #include <string>
 #include <vector>
 
-#include "hanal/Morph.hpp"
-#include "hanal/Word.hpp"
+#include "hanal/CharBuffer.hpp"
+#include "hanal/Util.hpp"
 
 
 namespace hanal {
@@ -25,18 +25,18 @@ namespace hanal {
 ////////////////////
 // ctors and dtor //
 ////////////////////
-_trellis_node_t::_trellis_node_t(const SHDPTRVEC(Morph)& anal_result_)
+_trellis_node_t::_trellis_node_t(const std::vector<morph_id_t>& anal_result_)
     : anal_result(anal_result_) {
 }
 
 
-std::string _trellis_node_t::str() {
+std::string _trellis_node_t::str(const MorphTable& morphs) {
   std::ostringstream oss;
-  oss << Morph::str(anal_result) << std::endl;
+  oss << morphs.str(anal_result) << std::endl;
   if (left_edges.size() > 0) {
     oss << "    [LEFT]  ";
     for (auto& edge : left_edges) {
-      oss << Morph::str(edge->anal_result);
+      oss << morphs.str(edge->anal_result);
       if (edge != left_edges.back()) oss << " || ";
     }
   }
@@ -44,7 +44,7 @@ std::string _trellis_node_t::str() {
   if (right_edges.size() > 0) {
     oss << "    [RIGHT] ";
     for (auto& edge : right_edges) {
-      oss << Morph::str(edge->anal_result);
+      oss << morphs.str(edge->anal_result);
       if (edge != right_edges.back()) oss << " || ";
     }
   }
@@ -52,12 +52,17 @@ std::string _trellis_node_t::str() {
 }
 
 
-ViterbiTrellis::ViterbiTrellis(const SHDPTRVEC(Word)& words)
-    : nodes(Word::char_len(words)) {
+ViterbiTrellis::ViterbiTrellis(const CharBuffer& chars, const MorphTable& dic_morphs)
+    : nodes(chars.size()), morphs(&dic_morphs), _chars(&chars) {
 }
 
 
-void ViterbiTrellis::add_node(const SHDPTRVEC(Morph)& anal_result, int idx, int len) {
+ViterbiTrellis::ViterbiTrellis(const CharBuffer& chars, int char_idx, int char_end, const MorphTable& dic_morphs)
+    : nodes(char_end - char_idx), morphs(&dic_morphs), _chars(&chars), _char_idx(char_idx) {
+}
+
+
+void ViterbiTrellis::add_node(const std::vector<morph_id_t>& anal_result, int idx, int len) {
   auto curr_node = std::make_shared<_trellis_node_t>(anal_result);
   auto& curr_node_vec = nodes[idx + len - 1];
   curr_node_vec.emplace_back(curr_node);
@@ -76,10 +81,12 @@ std::string ViterbiTrellis::str() {
 
   for (int idx = 0; idx < nodes.size(); ++idx) {
     auto& nodes_idx = nodes[idx];
-    oss << "[" << idx << "] '" << "'" << std::endl;
+    int char_idx = _char_idx + idx;
+    oss << "[" << idx << "] '" << Util::to_utf8(std::wstring(1, _chars->wchars[char_idx])) << "' ("
+        << _chars->starts[char_idx] << ", " << _chars->ends[char_idx] << ")" << std::endl;
     for (int jdx = 0; jdx < nodes_idx.size(); ++jdx) {
       auto& node = nodes_idx[jdx];
-      oss << "  [" << jdx << "] " << node->str() << std::endl;
+      oss << "  [" << jdx << "] " << node->str(morphs) << std::endl;
     }
   }
 
@@ -11,18 +11,19 @@
 //////////////
 // includes //
 //////////////
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "hanal/macro.hpp"
+#include "hanal/MorphTable.hpp"
 
 
 namespace hanal {
 
 
-class Word;
-class Morph;
+class CharBuffer;
 
 
 /**
@@ -31,9 +32,9 @@ class Morph;
 struct _trellis_node_t {
   SHDPTRVEC(_trellis_node_t) left_edges;
   SHDPTRVEC(_trellis_node_t) right_edges;
-  const SHDPTRVEC(Morph)& anal_result;    ///< analysis result (vector of morphemes)
-  explicit _trellis_node_t(const SHDPTRVEC(Morph)& anal_result_);    ///< ctor
-  std::string str();    ///< get string for debugging
+  std::vector<morph_id_t> anal_result;    ///< analysis result (vector of morpheme IDs)
+  explicit _trellis_node_t(const std::vector<morph_id_t>& anal_result_);    ///< ctor
+  std::string str(const MorphTable& morphs);    ///< get string for debugging
 };
 
 
@@ -44,18 +45,38 @@ class ViterbiTrellis {
  public:
   /** @brief  node positions (same to length of non-space characters) */
   std::vector<SHDPTRVEC(_trellis_node_t)> nodes;
+  MorphTable morphs;    ///< local table of morphemes (estimated unknown words) over table of dictionary
+  std::vector<uint8_t> lookup_starts;    ///< flags of lookup starts in word being analyzed (reused among words)
 
-  explicit ViterbiTrellis(const SHDPTRVEC(Word)& words);    ///< ctor
+  /**
+   * @brief              ctor
+   * @param  chars       characters
+   * @param  dic_morphs  table of morphemes of dictionary
+   */
+  ViterbiTrellis(const CharBuffer& chars, const MorphTable& dic_morphs);
+
+  /**
+   * @brief              ctor for a range of characters (a sentence of document)
+   * @param  chars       characters of document
+   * @param  char_idx    start character index
+   * @param  char_end    end character index (exclusive)
+   * @param  dic_morphs  table of morphemes of dictionary
+   */
+  ViterbiTrellis(const CharBuffer& chars, int char_idx, int char_end, const MorphTable& dic_morphs);
 
   /**
    * @brief               add node with given analysis result into idx position
-   * @param  anal_result  analysis result (vector of morphemes)
+   * @param  anal_result  analysis result (vector of morpheme IDs of dictionary or local table)
    * @param  idx          index of insert position
    * @param  len          character length
    */
-  void add_node(const SHDPTRVEC(Morph)& anal_result, int idx, int len);
+  void add_node(const std::vector<morph_id_t>& anal_result, int idx, int len);
 
   std::string str();    ///< get string for debugging
+
+ private:
+  const CharBuffer* _chars = nullptr;    ///< characters of sentence
+  int _char_idx = 0;    ///< character index of first node
 };
 
 
@@ -12,10 +12,12 @@
 //////////////
 #include <algorithm>
 #include <list>
+#include <utility>
 #include <vector>
 #include <set>
 
 #include "hanal/Char.hpp"
+#include "hanal/CharBuffer.hpp"
 #include "hanal/MorphDic.hpp"
 #include "hanal/ViterbiTrellis.hpp"
 
@@ -26,150 +28,178 @@ namespace hanal {
 ////////////////////
 // ctors and dtor //
 ////////////////////
-Word::Word(SHDPTR(Char) char_, int char_idx_)
-    : chars(1, char_), char_idx(char_idx_) {
+Word::Word(int begin_, int end_, int char_idx_, int char_end_)
+    : begin(begin_), end(end_), char_idx(char_idx_), char_end(char_end_) {
 }
 
 
 /////////////
 // methods //
 /////////////
-SHDPTRVEC(Word) Word::tokenize(const char* text) {
-  auto chars_ = Char::characterize(text);
-  SHDPTRVEC(Word) words;
-  int char_idx = 0;
-  bool is_in_space = true;
-  for (auto& char_ : chars_) {
-    if (char_->is_space()) {
-      is_in_space = true;
+std::vector<Word> Word::tokenize(const char* text, CharBuffer* chars) {
+  chars->characterize(text);
+  return tokenize(*chars);
+}
+
+
+std::vector<Word> Word::tokenize(const char* text, size_t len, CharBuffer* chars) {
+  chars->characterize(text, len);
+  return tokenize(*chars);
+}
+
+
+std::vector<Word> Word::tokenize(const CharBuffer& chars) {
+  std::vector<Word> words;
+  for (int char_idx = 0; char_idx < chars.size(); ++char_idx) {
+    if (chars.is_word_start(char_idx)) {
+      words.emplace_back(chars.starts[char_idx], chars.ends[char_idx], char_idx, char_idx + 1);
     } else {
-      if (is_in_space) {
-        // first character => start of word
-        words.emplace_back(std::make_shared<Word>(char_, char_idx));
-      } else {
-        words.back()->chars.emplace_back(char_);
-      }
-      is_in_space = false;
-      char_idx += 1;
+      words.back().end = chars.ends[char_idx];
+      words.back().char_end += 1;
     }
   }
   return words;
 }
 
 
-/////////////
-// methods //
-/////////////
-int Word::char_len(const SHDPTRVEC(Word)& words) {
+int Word::char_len(const std::vector<Word>& words) {
   int length_sum = 0;
   for (auto& word : words) {
-    length_sum += word->chars.size();
+    length_sum += word.size();
   }
   return length_sum;
 }
 
 
-std::wstring Word::to_wstr() {
-  std::wostringstream wss;
-  for (auto& char_ : chars) {
-    wss << char_->wchar;
-  }
-  return wss.str();
+int Word::size() const {
+  return char_end - char_idx;
 }
 
 
-std::wstring Word::to_wstr_reversed() {
-  std::wostringstream wss;
-  for (auto iter = chars.rbegin(); iter != chars.rend(); ++iter) {
-    wss << (*iter)->wchar;
-  }
-  return wss.str();
+std::wstring Word::to_wstr(const CharBuffer& chars) const {
+  return std::wstring(chars.wchars.begin() + char_idx, chars.wchars.begin() + char_end);
+}
+
+
+std::wstring Word::to_wstr_reversed(const CharBuffer& chars) const {
+  std::wstring text = to_wstr(chars);
+  std::reverse(text.begin(), text.end());
+  return text;
 }
 
 
-void Word::analyze_forward(MorphDic* morph_dic, ViterbiTrellis* trellis, int trellis_idx) {
-  std::wstring text = to_wstr();
-  std::set<int> lookup_starts = {0};
-  while (lookup_starts.size() > 0) {
-    int lookup_start = *lookup_starts.begin();
-    auto matches = morph_dic->lookup(&text[lookup_start]);
-    if (matches.size() == 0) {
-      for (auto& match_len : _estimate_unk_word_forward(trellis, trellis_idx, lookup_start)) {
-        if ((lookup_start + match_len) < text.length()) lookup_starts.insert(lookup_start + match_len);
+void Word::analyze_forward(const CharBuffer& chars, MorphDic* morph_dic, ViterbiTrellis* trellis,
+                           int trellis_idx) const {
+  const wchar_t* text = chars.wchars.data() + char_idx;    // read characters in place
+  int text_len = size();
+  // lookup starts are only added after current one, so visit them in order of position
+  auto& lookup_starts = trellis->lookup_starts;    // buffer of trellis is reused without allocation for each word
+  lookup_starts.assign(text_len, 0);
+  lookup_starts[0] = 1;
+  auto add_match = [&] (int lookup_start, int match_len, int val_idx) {
+    auto anal_results = morph_dic->value(val_idx);    // hold value while adding nodes
+    for (auto& anal_result : *anal_results) {
+      trellis->add_node(anal_result, trellis_idx + lookup_start, match_len);
+    }
+    if ((lookup_start + match_len) < text_len) lookup_starts[lookup_start + match_len] = 1;
+  };
+
+  // with Aho-Corasick automaton, find all matches in word at once and sort them by (start, length)
+  auto& aho_corasick = morph_dic->aho_corasick();
+  std::vector<std::pair<int, Trie::match_t>> all_matches;    // (start, match)
+  if (!aho_corasick.empty()) {
+    aho_corasick.search(text, text_len, [&all_matches] (int end, const Trie::match_t& match) {
+      all_matches.emplace_back(end - match.len, match);
+    });
+    std::sort(all_matches.begin(), all_matches.end(),
+              [] (const std::pair<int, Trie::match_t>& lhs, const std::pair<int, Trie::match_t>& rhs) {
+      return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.second.len < rhs.second.len);
+    });
+  }
+  auto match_iter = all_matches.begin();
+
+  for (int lookup_start = 0; lookup_start < text_len; ++lookup_start) {
+    if (!lookup_starts[lookup_start]) continue;
+    int match_num = 0;
+    if (!aho_corasick.empty()) {
+      while (match_iter != all_matches.end() && match_iter->first < lookup_start) ++match_iter;
+      for (; match_iter != all_matches.end() && match_iter->first == lookup_start; ++match_iter) {
+        add_match(lookup_start, match_iter->second.len, match_iter->second.val_idx);
+        ++match_num;
       }
     } else {
-      for (auto& match : matches) {
-        for (auto& anal_result : morph_dic->value(match.val_idx)) {
-          trellis->add_node(anal_result, trellis_idx + lookup_start, match.len);
-        }
-        if ((lookup_start + match.len) < text.length()) lookup_starts.insert(lookup_start + match.len);
+      for (auto cursor = morph_dic->cursor(); lookup_start + cursor.depth() < text_len; ) {
+        if (!cursor.step(text[lookup_start + cursor.depth()])) break;
+        if (cursor.value() < 0) continue;
+        add_match(lookup_start, cursor.depth(), cursor.value());
+        ++match_num;
+      }
+    }
+    if (match_num == 0) {
+      for (auto& match_len : _estimate_unk_word_forward(chars, trellis, trellis_idx, lookup_start)) {
+        if ((lookup_start + match_len) < text_len) lookup_starts[lookup_start + match_len] = 1;
       }
     }
-    lookup_starts.erase(lookup_starts.begin());
   }
 }
 
 
-std::set<int> Word::_estimate_unk_word_forward(ViterbiTrellis* trellis, int trellis_idx, int lookup_start) {
+std::set<int> Word::_estimate_unk_word_forward(const CharBuffer& chars, ViterbiTrellis* trellis, int trellis_idx,
+                                               int lookup_start) const {
   std::set<int> match_lengths;
 
-  auto first_char = chars[lookup_start];
-  auto begin = chars.begin() + lookup_start;
-  auto end = chars.end();
-  if (Char::merge_strategy(first_char->type()) == Char::MergeStrategy::SEPARATELY) {
-    // only single character
-    end = begin + 1;
-  } else if (Char::merge_strategy(first_char->type()) == Char::MergeStrategy::BY_CHAR) {
+  auto& wchars = chars.wchars;
+  auto& types = chars.types;
+  int first_idx = char_idx + lookup_start;
+  auto first_type = types[first_idx];
+  auto strategy = Char::merge_strategy(wchars[first_idx]);
+  int last_idx = first_idx + 1;    // exclusive
+  if (strategy == Char::MergeStrategy::BY_CHAR) {
     // find end of lexically same characters
-    auto char_merge_pred = [&first_char] (const SHDPTR(Char)& merge_char) {
-        return first_char->wchar == merge_char->wchar;
-    };
-    end = std::find_if_not(begin + 1, chars.end(), char_merge_pred);
-  } else if (Char::merge_strategy(first_char->type()) == Char::MergeStrategy::BY_TYPE) {
+    while (last_idx < char_end && wchars[last_idx] == wchars[first_idx]) last_idx += 1;
+  } else if (strategy == Char::MergeStrategy::BY_TYPE) {
     // find end of same type characters
-    auto type_merge_pred = [&first_char] (const SHDPTR(Char)& merge_char) {
-        return first_char->type() == merge_char->type();
-    };
-    end = std::find_if_not(begin + 1, chars.end(), type_merge_pred);
+    while (last_idx < char_end && types[last_idx] == first_type) last_idx += 1;
   }
+  // SEPARATELY: only single character
 
-  int match_length = end - begin;
-  _add_unk_word(trellis, trellis_idx, lookup_start, match_length);
+  int match_length = last_idx - first_idx;
+  _add_unk_word(chars, trellis, trellis_idx, lookup_start, match_length);
   match_lengths.insert(match_length);
 
-  if (first_char->type() == Char::Type::HANGUL) {
+  if (first_type == Char::Type::HANGUL) {
     // add more estimated words for Hangul. 1, 2 and (match_length - 1)
-    if (match_length > 1) _add_unk_word(trellis, trellis_idx, lookup_start, 1);
-    if (match_length > 2) _add_unk_word(trellis, trellis_idx, lookup_start, 2);
-    if (match_length > 3) _add_unk_word(trellis, trellis_idx, lookup_start, match_length - 1);
+    if (match_length > 1) _add_unk_word(chars, trellis, trellis_idx, lookup_start, 1);
+    if (match_length > 2) _add_unk_word(chars, trellis, trellis_idx, lookup_start, 2);
+    if (match_length > 3) _add_unk_word(chars, trellis, trellis_idx, lookup_start, match_length - 1);
   }
 
   return match_lengths;
 }
 
 
-void Word::_add_unk_word(ViterbiTrellis* trellis, int trellis_idx, int lookup_start, int length) {
-  std::unique_ptr<wchar_t[]> lex(new wchar_t[length + 1]);
-  for (int idx = 0; idx < length; ++idx) {
-    lex[idx] = chars[lookup_start + idx]->wchar;
-  }
-  SHDPTR(Morph) morph = std::make_shared<Morph>(std::move(lex), chars[lookup_start]->estimate_pos_tag());
-  SHDPTRVEC(Morph) estimated_result;
-  estimated_result.emplace_back(morph);
+void Word::_add_unk_word(const CharBuffer& chars, ViterbiTrellis* trellis, int trellis_idx, int lookup_start,
+                         int length) const {
+  int first_idx = char_idx + lookup_start;
+  auto pos_tag = Char::estimate_pos_tag(chars.types[first_idx]);
+  std::vector<morph_id_t> estimated_result(1, trellis->morphs.intern(chars.wchars.data() + first_idx, length,
+                                                                      pos_tag));
   trellis->add_node(estimated_result, trellis_idx + lookup_start, length);
 }
 
 
-void Word::analyze_backward(MorphDic* morph_dic, ViterbiTrellis* trellis, int trellis_idx) {
-  std::wstring text_reversed = to_wstr_reversed();
+void Word::analyze_backward(const CharBuffer& chars, MorphDic* morph_dic, ViterbiTrellis* trellis,
+                            int trellis_idx) const {
+  std::wstring text_reversed = to_wstr_reversed(chars);
   // TODO(krikit): analyze reversed direction (at the end of word)
   HANAL_THROW("Not implemented yet");
 }
 
 
 Word& Word::operator+=(const Word& that) {
-  HANAL_ASSERT(this->char_idx + this->chars.size() == that.char_idx, "Can merge only adjacent words");
-  chars.insert(chars.end(), that.chars.begin(), that.chars.end());
+  HANAL_ASSERT(this->char_end == that.char_idx, "Can merge only adjacent words");
+  end = that.end;
+  char_end = that.char_end;
   return *this;
 }
 
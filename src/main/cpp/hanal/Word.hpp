@@ -13,7 +13,9 @@
 //////////////
 #include <memory>
 #include <set>
+#include <cstddef>
 #include <string>
+#include <vector>
 
 #include "hanal/macro.hpp"
 
@@ -21,64 +23,89 @@
 namespace hanal {
 
 
-class Char;
-class Morph;
+class CharBuffer;
 class MorphDic;
 class ViterbiTrellis;
 
 
 /**
  * Korean word (aka EoJeol). It's not like English words.
+ * word is a span of characters in sentence's character buffer.
  * see: http://nlp.stanford.edu/fsnlp/korean.html
  */
 class Word {
  public:
-  SHDPTRVEC(Char) chars;    ///< vector of Korean characters consisting word
+  int begin = -1;    ///< start position (code unit offset, inclusive) of original text
+  int end = -1;    ///< end position (code unit offset, exclusive) of original text
   int char_idx = -1;    ///< start position index (Korean character index in sentence except white spaces)
+  int char_end = -1;    ///< end position index (exclusive)
 
-  explicit Word(SHDPTR(Char) char_, int char_idx_);    ///< ctor
+  explicit Word(int begin_, int end_, int char_idx_, int char_end_);    ///< ctor
 
   /**
-   * @brief        tokenize UTF-8 text into words
-   * @param  text  input text
-   * @return       vector of words
+   * @brief         tokenize UTF-8 text into words
+   * @param  text   input text
+   * @param  chars  [out] characters of text
+   * @return        vector of words
    */
-  static SHDPTRVEC(Word) tokenize(const char* text);
+  static std::vector<Word> tokenize(const char* text, CharBuffer* chars);
+
+  /**
+   * @brief         tokenize UTF-8 text with length (not necessarily null terminated) into words
+   * @param  text   input text
+   * @param  len    length of text in bytes
+   * @param  chars  [out] characters of text
+   * @return        vector of words
+   */
+  static std::vector<Word> tokenize(const char* text, size_t len, CharBuffer* chars);
+
+  /**
+   * @brief         tokenize characterized text into words
+   * @param  chars  characters of text
+   * @return        vector of words
+   */
+  static std::vector<Word> tokenize(const CharBuffer& chars);
 
   /**
    * @brief         length of characters in all words
    * @param  words  vector of words
    * @return        length of characters
    */
-  static int char_len(const SHDPTRVEC(Word)& words);
+  static int char_len(const std::vector<Word>& words);
+
+  int size() const;    ///< number of characters
 
   /**
-   * @brief   convert to wide string text
-   * @return  wide string text
+   * @brief         convert to wide string text
+   * @param  chars  characters of sentence
+   * @return        wide string text
    */
-  std::wstring to_wstr();
+  std::wstring to_wstr(const CharBuffer& chars) const;
 
   /**
-   * @brief   convert to reversed wide string text
-   * @return  wide string text
+   * @brief         convert to reversed wide string text
+   * @param  chars  characters of sentence
+   * @return        wide string text
    */
-  std::wstring to_wstr_reversed();
+  std::wstring to_wstr_reversed(const CharBuffer& chars) const;
 
   /**
    * @brief               forward(left to right) analyze word and add nodes to trellis
+   * @param  chars        characters of sentence
    * @param  morph_dic    morpheme dictionary
    * @param  trellis      Viterbi trellis
    * @param  trellis_idx  trellis index to add analyzed results
    */
-  void analyze_forward(MorphDic* morph_dic, ViterbiTrellis* trellis, int trellis_idx);
+  void analyze_forward(const CharBuffer& chars, MorphDic* morph_dic, ViterbiTrellis* trellis, int trellis_idx) const;
 
   /**
    * @brief               backward(right to left) analyze word and add nodes to trellis
+   * @param  chars        characters of sentence
    * @param  morph_dic    morpheme dictionary
    * @param  trellis      Viterbi trellis
    * @param  trellis_idx  trellis index to add analyzed results
    */
-  void analyze_backward(MorphDic* morph_dic, ViterbiTrellis* trellis, int trellis_idx);
+  void analyze_backward(const CharBuffer& chars, MorphDic* morph_dic, ViterbiTrellis* trellis, int trellis_idx) const;
 
   /**
    * @brief        merge two words into single word
@@ -90,21 +117,25 @@ class Word {
  private:
   /**
    * @brief                unknown word estimation (forward)
+   * @param  chars         characters of sentence
    * @param  trellis       Viterbi trellis
    * @param  trellis_idx   trellis index to add estimated results
    * @param  lookup_start  start position of lookup
    * @return               set of match lengths
    */
-  std::set<int> _estimate_unk_word_forward(ViterbiTrellis* trellis, int trellis_idx, int lookup_start);
+  std::set<int> _estimate_unk_word_forward(const CharBuffer& chars, ViterbiTrellis* trellis, int trellis_idx,
+                                           int lookup_start) const;
 
   /**
    * @brief                add estimated unknown word
+   * @param  chars         characters of sentence
    * @param  trellis       Viterbi trellis
    * @param  trellis_idx   trellis index to add estimated results
    * @param  lookup_start  start position of lookup
    * @param  length        length of unknown word from start position
    */
-  void _add_unk_word(ViterbiTrellis* trellis, int trellis_idx, int lookup_start, int length);
+  void _add_unk_word(const CharBuffer& chars, ViterbiTrellis* trellis, int trellis_idx, int lookup_start,
+                     int length) const;
 };
 
 
@@ -16,7 +16,6 @@
 #include <vector>
 
 #include "boost/lexical_cast.hpp"
-#include "hanal/Except.hpp"
 #include "hanal/HanalApi.hpp"
 #include "hanal/macro.hpp"
 
@@ -28,6 +27,26 @@ SHDPTRVEC(hanal::HanalApi) _handles{ hanal::HanalApi::create() };    // handles
 std::recursive_mutex _mutex;    // mutex to exclusively access handles
 
 
+///////////////
+// functions //
+///////////////
+/**
+ * @brief          get API object of handle with input text checked. entry points catch all exceptions (ex. lone
+ *                 surrogate in UTF-16 input) since they must not escape C API
+ * @param  handle  handle got from open
+ * @param  text    input text
+ * @return         API object copied under lock, so that it outlives concurrent close while caller holds it. nullptr
+ *                 if handle is invalid (or closed) or text is null
+ */
+static SHDPTR(hanal::HanalApi) _get_api(int handle, const void* text) {
+  // TODO(krikit): there should be method to notice error message
+  if (text == nullptr) return nullptr;
+  std::unique_lock<std::recursive_mutex> lock(_mutex);
+  if (handle <= 0 || handle >= static_cast<int>(_handles.size())) return nullptr;
+  return _handles[handle];
+}
+
+
 /////////////
 // methods //
 /////////////
@@ -42,11 +61,11 @@ int hanal_open(const char* rsc_dir, const char* opt_str) {
     return -1;
   }
   std::unique_lock<std::recursive_mutex> lock(_mutex);
-  auto hanal_api = hanal::HanalApi::create();
   try {
+    auto hanal_api = hanal::HanalApi::create();
     hanal_api->open(rsc_dir, opt_str);
     _handles.emplace_back(hanal_api);
-  } catch (hanal::Except& exc) {
+  } catch (...) {
     return -1;
     // TODO(krikit): there should be method to notice error message
   }
@@ -56,19 +75,72 @@ int hanal_open(const char* rsc_dir, const char* opt_str) {
 
 void hanal_close(int handle) {
   std::unique_lock<std::recursive_mutex> lock(_mutex);
+  if (handle <= 0 || handle >= static_cast<int>(_handles.size())) return;
   _handles[handle].reset();
 }
 
 
 const char* hanal_pos_tag(int handle, const char* sent, const char* opt_str) {
-  if (handle <= 0 || handle >= _handles.size()) {
-    // TODO(krikit): there should be method to notice error message
+  try {
+    auto hanal_api = _get_api(handle, sent);
+    if (hanal_api == nullptr) return nullptr;
+    return hanal_api->pos_tag(sent, opt_str).c_str();
+  } catch (...) {
     return nullptr;
   }
-  if (sent == nullptr) {
-    // TODO(krikit): there should be method to notice error message
+}
+
+
+const char* hanal_pos_tag_u16(int handle, const char16_t* sent, const char* opt_str) {
+  try {
+    auto hanal_api = _get_api(handle, sent);
+    if (hanal_api == nullptr) return nullptr;
+    return hanal_api->pos_tag(sent, opt_str).c_str();
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+
+const char* hanal_pos_tag_u32(int handle, const char32_t* sent, const char* opt_str) {
+  try {
+    auto hanal_api = _get_api(handle, sent);
+    if (hanal_api == nullptr) return nullptr;
+    return hanal_api->pos_tag(sent, opt_str).c_str();
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+
+const char* hanal_pos_tag_doc(int handle, const char* doc, const char* opt_str) {
+  try {
+    auto hanal_api = _get_api(handle, doc);
+    if (hanal_api == nullptr) return nullptr;
+    return hanal_api->pos_tag_doc(doc, opt_str).c_str();
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+
+const char* hanal_pos_tag_len(int handle, const char* sent, size_t len, const char* opt_str) {
+  try {
+    auto hanal_api = _get_api(handle, sent);
+    if (hanal_api == nullptr) return nullptr;
+    return hanal_api->pos_tag(sent, len, opt_str).c_str();
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+
+const char* hanal_pos_tag_doc_len(int handle, const char* doc, size_t len, const char* opt_str) {
+  try {
+    auto hanal_api = _get_api(handle, doc);
+    if (hanal_api == nullptr) return nullptr;
+    return hanal_api->pos_tag_doc(doc, len, opt_str).c_str();
+  } catch (...) {
     return nullptr;
   }
-  auto hanal_api = _handles[handle];
-  return hanal_api->pos_tag(sent, opt_str).c_str();
 }
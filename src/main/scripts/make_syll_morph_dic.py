@@ -26,6 +26,7 @@ import trie
 #############
 _ANAL_RESULT_DELIM = u'\1'    # delimiter between ambiguous analisys results
 _MORPH_DELIM = u'\2'    # delimiter between morphemes in single analysis result
+_VAL_OFF_MAGIC = 0x4F564E48    # magic number of value offsets file ("HNVO" in little endian)
 
 
 ########
@@ -59,6 +60,7 @@ def main(fin, output_stem):
   fout_key = open('%s.trie' % output_stem, 'wb')
   fout_val = open('%s.val' % output_stem, 'w')
   fout_val_idx = open('%s.val.len' % output_stem, 'wb')
+  val_offsets = [0]
   val_serial = 0
   nodes = trie_root.breadth_first_traverse()
   for idx, node in enumerate(nodes):
@@ -70,7 +72,12 @@ def main(fin, output_stem):
       uni_val = (node.value + u'\0').encode('UTF-32LE')
       fout_val.write(uni_val)
       fout_val_idx.write(struct.pack('h', len(uni_val) / 4))    # length include terminating zero value
+      val_offsets.append(val_offsets[-1] + len(uni_val) / 4)    # offset of value in characters
     fout_key.write(node.pack(val_idx))
+  # header (magic, number of values, total length), offsets and total length at the end
+  fout_val_off = open('%s.val.off' % output_stem, 'wb')
+  fout_val_off.write(struct.pack('iii', _VAL_OFF_MAGIC, val_serial, val_offsets[-1]))
+  fout_val_off.write(struct.pack('%di' % len(val_offsets), *val_offsets))
   logging.info('Number of nodes: %d', len(nodes))
   logging.info('Number of values: %d', val_serial)
 
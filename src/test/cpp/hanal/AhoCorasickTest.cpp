@@ -0,0 +1,143 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+//////////////
+// includes //
+//////////////
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hanal/AhoCorasick.hpp"
+#include "hanal/DicBuilder.hpp"
+#include "hanal/Except.hpp"
+#include "hanal/TrieBuilder.hpp"
+
+
+extern std::map<std::string, std::string> prog_args;    // arguments passed to main program
+
+
+/**
+ * test fixture for AhoCorasick
+ */
+class AhoCorasickTest: public testing::Test {
+ protected:
+  virtual void SetUp() {
+    auto iter = prog_args.find("rsc-dir");
+    if (iter == prog_args.end()) FAIL() << "--rsc-dir argument required";
+    morph_trie_path = prog_args["rsc-dir"] + "/morph.trie";
+    ASSERT_NO_THROW(morph_trie.open(morph_trie_path));
+  }
+
+  /**
+   * @brief        all matches by common prefix search at every start position
+   * @param  trie  trie
+   * @param  text  text
+   * @return       sorted (start, length, value index) of matches
+   */
+  std::vector<std::tuple<int, int, int>> prefix_matches(const hanal::Trie& trie, const std::wstring& text) {
+    std::vector<std::tuple<int, int, int>> matches;
+    for (int start = 0; start < text.size(); ++start) {
+      for (auto& match : trie.search_common_prefix_matches(text.c_str() + start, text.size() - start)) {
+        matches.emplace_back(start, match.len, match.val_idx);
+      }
+    }
+    std::sort(matches.begin(), matches.end());
+    return matches;
+  }
+
+  /**
+   * @brief                all matches by Aho-Corasick automaton
+   * @param  aho_corasick  automaton
+   * @param  text          text
+   * @return               sorted (start, length, value index) of matches
+   */
+  std::vector<std::tuple<int, int, int>> ac_matches(const hanal::AhoCorasick& aho_corasick, const std::wstring& text) {
+    std::vector<std::tuple<int, int, int>> matches;
+    int prev_end = 0;
+    int prev_len = 0;
+    int match_num = aho_corasick.search(text.c_str(), text.size(), [&] (int end, const hanal::Trie::match_t& match) {
+      EXPECT_LE(prev_end, end);
+      if (prev_end == end) EXPECT_GT(prev_len, match.len);    // longest one first
+      prev_end = end;
+      prev_len = match.len;
+      matches.emplace_back(end - match.len, match.len, match.val_idx);
+    });
+    EXPECT_EQ(matches.size(), match_num);
+    std::sort(matches.begin(), matches.end());
+    return matches;
+  }
+
+  hanal::Trie morph_trie;
+  std::string morph_trie_path;    ///< path for morphemes trie
+};
+
+
+TEST_F(AhoCorasickTest, search) {
+  hanal::AhoCorasick aho_corasick;
+  EXPECT_TRUE(aho_corasick.empty());
+  ASSERT_NO_THROW(aho_corasick.build(morph_trie));
+  EXPECT_FALSE(aho_corasick.empty());
+
+  for (std::wstring text : {L"accelerations", L"aaccelerationsacceleration", L"뷁accel뷁", L"a", L""}) {
+    EXPECT_EQ(prefix_matches(morph_trie, text), ac_matches(aho_corasick, text));
+  }
+  EXPECT_EQ(0, aho_corasick.search(L"accel", 0, [] (int, const hanal::Trie::match_t&) {}));
+  EXPECT_THROW(aho_corasick.search(nullptr, 0, [] (int, const hanal::Trie::match_t&) {}), hanal::Except);
+
+  aho_corasick.clear();
+  EXPECT_TRUE(aho_corasick.empty());
+}
+
+
+TEST_F(AhoCorasickTest, formats) {
+  std::string packed_path = "AhoCorasickTest.morph.packed.trie";    // in current directory
+  std::string da_path = "AhoCorasickTest.morph.da.trie";
+  hanal::TrieBuilder::to_packed(morph_trie_path, packed_path);
+  hanal::TrieBuilder::to_double_array(morph_trie_path, da_path);
+  hanal::Trie packed;
+  hanal::Trie da;
+  packed.open(packed_path);
+  da.open(da_path);
+
+  hanal::AhoCorasick aho_corasick;
+  ASSERT_NO_THROW(aho_corasick.build(packed));
+  std::wstring text = L"aaccelerationsacceleration";
+  EXPECT_EQ(prefix_matches(morph_trie, text), ac_matches(aho_corasick, text));
+  EXPECT_THROW(aho_corasick.build(da), hanal::Except);    // double-array is not supported
+
+  packed.close();
+  da.close();
+  std::remove(packed_path.c_str());
+  std::remove(da_path.c_str());
+}
+
+
+TEST_F(AhoCorasickTest, layout) {
+  // after layout, "abc" (depth 3) comes before "xy" (depth 2), so nodes are not in breadth first order
+  std::istringstream tsv("abc\tabc/SL\nbc\tbc/SL\nc\tc/SL\nxy\txy/SL\n");
+  hanal::DicBuilder::build_morph(tsv, "AhoCorasickTest.layout");
+  std::istringstream profile("abc\t100\n");
+  hanal::DicBuilder::layout_morph("AhoCorasickTest.layout", profile);
+  hanal::Trie trie;
+  trie.open("AhoCorasickTest.layout.trie");
+
+  hanal::AhoCorasick aho_corasick;
+  ASSERT_NO_THROW(aho_corasick.build(trie));
+  for (std::wstring text : {L"abc", L"abcxy", L"xabcbc", L"cxyabc"}) {
+    EXPECT_EQ(prefix_matches(trie, text), ac_matches(aho_corasick, text));
+  }
+
+  trie.close();
+  for (std::string ext : {".trie", ".val", ".val.len", ".val.off"}) {
+    std::remove(("AhoCorasickTest.layout" + ext).c_str());
+  }
+}
@@ -0,0 +1,119 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+//////////////
+// includes //
+//////////////
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hanal/CharBuffer.hpp"
+#include "hanal/Except.hpp"
+
+
+/**
+ * test fixture for CharBuffer
+ */
+class CharBufferTest: public testing::Test {
+};
+
+
+TEST_F(CharBufferTest, characterize) {
+  const char* text = u8"A À　가";    // A, (space), À, (wide space), 가
+  hanal::CharBuffer chars;
+  chars.characterize(text);
+  EXPECT_EQ(3, chars.size());    // white spaces are removed
+  EXPECT_EQ(text, chars.text);
+  EXPECT_EQ(L'A', chars.wchars[0]);    // 'A' with length 1
+  EXPECT_EQ(0, chars.starts[0]);
+  EXPECT_EQ(1, chars.ends[0]);
+  EXPECT_EQ(hanal::Char::Type::LATIN, chars.types[0]);
+  EXPECT_EQ(L'À', chars.wchars[1]);    // 'À' with length 2
+  EXPECT_EQ(2, chars.starts[1]);
+  EXPECT_EQ(4, chars.ends[1]);
+  EXPECT_EQ(hanal::Char::Type::LATIN, chars.types[1]);
+  EXPECT_EQ(L'가', chars.wchars[2]);    // '가' with length 3
+  EXPECT_EQ(7, chars.starts[2]);
+  EXPECT_EQ(10, chars.ends[2]);
+  EXPECT_EQ(hanal::Char::Type::HANGUL, chars.types[2]);
+
+  EXPECT_TRUE(chars.is_word_start(0));
+  EXPECT_TRUE(chars.is_word_start(1));
+  EXPECT_TRUE(chars.is_word_start(2));
+
+  chars.characterize("");    // zero length text
+  EXPECT_EQ(0, chars.size());
+
+  EXPECT_THROW(chars.characterize(static_cast<const char*>(nullptr)), hanal::Except);    // null pointer
+  EXPECT_THROW(chars.characterize("\xFE"), hanal::Except);    // invalid UTF-8 character
+}
+
+
+TEST_F(CharBufferTest, compose_jamo) {
+  // "가 닭\u1100" in conjoining jamo. 3 bytes for each jamo
+  const char* text = u8"\u1100\u1161 \u1103\u1161\u11B0\u1100";
+  hanal::CharBuffer chars;
+  chars.characterize(text);
+  EXPECT_EQ(3, chars.size());
+  EXPECT_EQ(L'가', chars.wchars[0]);
+  EXPECT_EQ(0, chars.starts[0]);
+  EXPECT_EQ(6, chars.ends[0]);
+  EXPECT_EQ(hanal::Char::Type::HANGUL, chars.types[0]);
+  EXPECT_EQ(L'닭', chars.wchars[1]);
+  EXPECT_EQ(7, chars.starts[1]);
+  EXPECT_EQ(16, chars.ends[1]);
+  EXPECT_EQ(L'\u1100', chars.wchars[2]);    // single leading consonant is left as it is
+  EXPECT_EQ(16, chars.starts[2]);
+  EXPECT_EQ(19, chars.ends[2]);
+  EXPECT_TRUE(chars.is_word_start(1));
+  EXPECT_FALSE(chars.is_word_start(2));
+}
+
+
+TEST_F(CharBufferTest, characterize_utf16_utf32) {
+  hanal::CharBuffer chars;
+  chars.characterize(u"A \U0001F600　가");    // A, (space), (surrogate pair), (wide space), 가
+  EXPECT_EQ(nullptr, chars.text);
+  EXPECT_EQ(3, chars.size());
+  EXPECT_EQ(std::vector<int>({0, 2, 5}), chars.starts);    // in UTF-16 code units
+  EXPECT_EQ(std::vector<int>({1, 4, 6}), chars.ends);
+  EXPECT_EQ(L'\U0001F600', chars.wchars[1]);
+  EXPECT_EQ(hanal::Char::Type::HANGUL, chars.types[2]);
+  EXPECT_THROW(chars.characterize(u"\xD800" u"A"), hanal::Except);    // lone surrogate
+
+  chars.characterize(U"A \U0001F600　가");
+  EXPECT_EQ(3, chars.size());
+  EXPECT_EQ(std::vector<int>({0, 2, 4}), chars.starts);    // in code points
+  EXPECT_EQ(std::vector<int>({1, 3, 5}), chars.ends);
+
+  chars.characterize(U"\u1100\u1161 \u1100\u1161\u11A8");    // conjoining jamo
+  EXPECT_EQ(std::wstring(L"가각"), std::wstring(chars.wchars.begin(), chars.wchars.end()));
+  EXPECT_EQ(std::vector<int>({0, 3}), chars.starts);
+  EXPECT_EQ(std::vector<int>({2, 6}), chars.ends);
+}
+
+
+TEST_F(CharBufferTest, characterize_with_length) {
+  // slices of text without null terminator
+  std::string text = u8"아버지가 방에 들어가신다.";
+  hanal::CharBuffer chars;
+  chars.characterize(text.c_str() + 13, 6);    // "방에"
+  EXPECT_EQ(text.c_str() + 13, chars.text);
+  EXPECT_EQ(std::wstring(L"방에"), std::wstring(chars.wchars.begin(), chars.wchars.end()));
+  EXPECT_EQ(std::vector<int>({0, 3}), chars.starts);
+  EXPECT_EQ(std::vector<int>({3, 6}), chars.ends);
+  chars.characterize(text.c_str(), 0);
+  EXPECT_EQ(0, chars.size());
+  EXPECT_THROW(chars.characterize(text.c_str(), 2), hanal::Except);    // truncated character
+
+  std::u16string text16 = u"아버지가 방에";
+  chars.characterize(text16.c_str() + 5, 1);
+  EXPECT_EQ(std::wstring(L"방"), std::wstring(chars.wchars.begin(), chars.wchars.end()));
+  std::u32string text32 = U"아버지가 방에";
+  chars.characterize(text32.c_str(), 3);
+  EXPECT_EQ(std::wstring(L"아버지"), std::wstring(chars.wchars.begin(), chars.wchars.end()));
+}
@@ -7,6 +7,9 @@
 //////////////
 // includes //
 //////////////
+#include <cwchar>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "hanal/Char.hpp"
 #include "hanal/Except.hpp"
@@ -19,43 +22,47 @@ class CharTest: public testing::Test {
 };
 
 
-TEST_F(CharTest, characterize) {
-  const char* text = u8"A \u00C0\u3000\uAC00";    // A, (space), À, (wide space), 가
-  auto chars = hanal::Char::characterize(text);
-  EXPECT_EQ(5, chars.size());
-  EXPECT_EQ(L'A', chars[0]->wchar);    // 'A' with length 1
-  EXPECT_EQ(text, chars[0]->start);
-  EXPECT_EQ(text + 1, chars[0]->end);
-  EXPECT_EQ(L' ', chars[1]->wchar);    // ' ' with length 1
-  EXPECT_EQ(text + 1, chars[1]->start);
-  EXPECT_EQ(text + 2, chars[1]->end);
-  EXPECT_EQ(L'\u00C0', chars[2]->wchar);    // 'À' with length 2
-  EXPECT_EQ(text + 2, chars[2]->start);
-  EXPECT_EQ(text + 4, chars[2]->end);
-  EXPECT_EQ(L'\u3000', chars[3]->wchar);    // '　' with length 3
-  EXPECT_EQ(text + 4, chars[3]->start);
-  EXPECT_EQ(text + 7, chars[3]->end);
-  EXPECT_EQ(L'\uAC00', chars[4]->wchar);    // '가' with length 3
-  EXPECT_EQ(text + 7, chars[4]->start);
-  EXPECT_EQ(text + 10, chars[4]->end);
-
-  auto zero_chars = hanal::Char::characterize("");    // zero length text
-  EXPECT_EQ(0, zero_chars.size());
-
-  EXPECT_THROW(hanal::Char::characterize(nullptr), hanal::Except);    // null pointer
-  EXPECT_THROW(hanal::Char::characterize("\xFE"), hanal::Except);    // invalid UTF-8 character
+TEST_F(CharTest, is_space) {
+  EXPECT_TRUE(hanal::Char::is_space(L' '));
+  EXPECT_TRUE(hanal::Char::is_space(L'\t'));
+  EXPECT_TRUE(hanal::Char::is_space(L'\v'));
+  EXPECT_TRUE(hanal::Char::is_space(L'\r'));
+  EXPECT_TRUE(hanal::Char::is_space(L'\n'));
+  EXPECT_TRUE(hanal::Char::is_space(L'\u3000'));    // (wide space)
+
+  EXPECT_FALSE(hanal::Char::is_space(L'A'));
+  EXPECT_FALSE(hanal::Char::is_space(L'\0'));
+  EXPECT_FALSE(hanal::Char::is_space(L'\uAC00'));    // '가'
 }
 
 
-TEST_F(CharTest, is_space) {
-  EXPECT_TRUE(hanal::Char(L' ', nullptr, nullptr).is_space());
-  EXPECT_TRUE(hanal::Char(L'\t', nullptr, nullptr).is_space());
-  EXPECT_TRUE(hanal::Char(L'\v', nullptr, nullptr).is_space());
-  EXPECT_TRUE(hanal::Char(L'\r', nullptr, nullptr).is_space());
-  EXPECT_TRUE(hanal::Char(L'\n', nullptr, nullptr).is_space());
-  EXPECT_TRUE(hanal::Char(L'\u3000', nullptr, nullptr).is_space());    // (wide space)
-
-  EXPECT_FALSE(hanal::Char(L'A', nullptr, nullptr).is_space());
-  EXPECT_FALSE(hanal::Char(L'\0', nullptr, nullptr).is_space());
-  EXPECT_FALSE(hanal::Char(L'\uAC00', nullptr, nullptr).is_space());    // '가'
+TEST_F(CharTest, type) {
+  EXPECT_EQ(hanal::Char::Type::SPACE, hanal::Char::type(L'\u3000'));    // (wide space)
+  EXPECT_EQ(hanal::Char::Type::HANGUL, hanal::Char::type(L'\uAC00'));    // '가'
+  EXPECT_EQ(hanal::Char::Type::LATIN, hanal::Char::type(L'\u00C0'));    // 'À'
+  EXPECT_EQ(hanal::Char::Type::NUMBER, hanal::Char::type(L'7'));
+  EXPECT_EQ(hanal::Char::Type::CJK, hanal::Char::type(L'\u4E00'));    // '一'
+  EXPECT_EQ(hanal::Char::Type::ELLIPSIS, hanal::Char::type(L'\u2026'));    // '…'
+  EXPECT_EQ(hanal::Char::Type::PERIOD, hanal::Char::type(L'?'));
+  EXPECT_EQ(hanal::Char::Type::O_MARK, hanal::Char::type(L'~'));
+  EXPECT_EQ(hanal::Char::Type::COMMA, hanal::Char::type(L','));
+  EXPECT_EQ(hanal::Char::Type::QUOTE, hanal::Char::type(L'"'));
+  EXPECT_EQ(hanal::Char::Type::SYMBOL, hanal::Char::type(L'@'));
+  EXPECT_EQ(hanal::Char::Type::FOREIGN, hanal::Char::type(L'\u03B1'));    // 'α'
+}
+
+
+TEST_F(CharTest, classify) {
+  const wchar_t* wchars = L"가 A1一…?~,\"@α\U0001F600";
+  std::vector<hanal::Char::Type> types(wcslen(wchars));
+  hanal::Char::classify(wchars, types.size(), types.data());
+  for (int idx = 0; idx < types.size(); ++idx) {
+    EXPECT_EQ(hanal::Char::type(wchars[idx]), types[idx]) << "idx: " << idx;
+  }
+  EXPECT_EQ(hanal::Char::Type::FOREIGN, types.back());    // supplementary plane
+
+  EXPECT_EQ(hanal::Char::MergeStrategy::BY_TYPE, hanal::Char::merge_strategy(L'가'));
+  EXPECT_EQ(hanal::Char::MergeStrategy::BY_CHAR, hanal::Char::merge_strategy(L'.'));
+  EXPECT_EQ(hanal::Char::MergeStrategy::SEPARATELY, hanal::Char::merge_strategy(L'('));
+  EXPECT_EQ(hanal::Char::merge_strategy(hanal::Char::Type::SYMBOL), hanal::Char::merge_strategy(L'@'));
 }
@@ -0,0 +1,148 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+//////////////
+// includes //
+//////////////
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hanal/DicBuilder.hpp"
+#include "hanal/Except.hpp"
+#include "hanal/MorphDic.hpp"
+#include "hanal/Trie.hpp"
+
+
+/**
+ * test fixture for DicBuilder
+ */
+class DicBuilderTest: public testing::Test {
+ protected:
+  virtual void TearDown() {
+    for (auto stem : {"DicBuilderTest.a", "DicBuilderTest.b"}) {    // in current directory
+      for (auto ext : {".trie", ".val", ".val.len", ".val.off"}) std::remove((std::string(stem) + ext).c_str());
+    }
+  }
+
+  /**
+   * @brief        read whole file
+   * @param  path  file path
+   * @return       contents
+   */
+  std::string read(std::string path) {
+    std::ifstream fin(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+  }
+};
+
+
+TEST_F(DicBuilderTest, build_morph) {
+  std::string tsv = "나\t나/NP\n\n가나\tB/NNG + C/JKS\n가\t가/VV + 아/EC\t가/JKS\n가나\tA/NNG\n  가나\tA/NNG  \n";
+  std::istringstream sin_a(tsv);
+  hanal::DicBuilder::build_morph(sin_a, "DicBuilderTest.a");
+  std::istringstream sin_b(tsv);
+  hanal::DicBuilder::build_morph(sin_b, "DicBuilderTest.b", 2, 1);    // a run for each entry and each depth
+  for (auto ext : {".trie", ".val", ".val.len", ".val.off"}) {
+    EXPECT_EQ(read(std::string("DicBuilderTest.a") + ext), read(std::string("DicBuilderTest.b") + ext));
+  }
+
+  hanal::Trie trie;
+  trie.open("DicBuilderTest.a.trie");
+  EXPECT_EQ(0, *trie.find(L"가"));    // values in breadth first order
+  EXPECT_EQ(1, *trie.find(L"나"));
+  EXPECT_EQ(2, *trie.find(L"가나"));
+  std::string vals = read("DicBuilderTest.a.val");
+  std::wstring wvals(reinterpret_cast<const wchar_t*>(vals.data()), vals.size() / sizeof(wchar_t));
+  EXPECT_EQ(std::wstring(L"가/VV\2아/EC\1가/JKS\0나/NP\0A/NNG\1B/NNG\2C/JKS\0", 39), wvals);
+  std::string lens = read("DicBuilderTest.a.val.len");
+  EXPECT_EQ(std::vector<int16_t>({16, 5, 18}),
+            std::vector<int16_t>(reinterpret_cast<const int16_t*>(lens.data()),
+                                 reinterpret_cast<const int16_t*>(lens.data() + lens.size())));
+  std::string offs = read("DicBuilderTest.a.val.off");
+  EXPECT_EQ(std::vector<int32_t>({hanal::MorphDic::VAL_OFF_MAGIC, 3, 39, 0, 16, 21, 39}),    // header and offsets
+            std::vector<int32_t>(reinterpret_cast<const int32_t*>(offs.data()),
+                                 reinterpret_cast<const int32_t*>(offs.data() + offs.size())));
+
+  std::istringstream no_tab("가나\n");
+  EXPECT_THROW(hanal::DicBuilder::build_morph(no_tab, "DicBuilderTest.a"), hanal::Except);
+  std::istringstream delim("가\t가/VV\1\n");
+  EXPECT_THROW(hanal::DicBuilder::build_morph(delim, "DicBuilderTest.a"), hanal::Except);
+}
+
+
+TEST_F(DicBuilderTest, layout_morph) {
+  std::string tsv = "가\t가/VV\n가나\t가나/NNG\n가다\t가/VV + 다/EC\n나\t나/NP\n나다\t나/VV + 다/EC\n다\t다/MAG\n";
+  std::istringstream sin_a(tsv);
+  hanal::DicBuilder::build_morph(sin_a, "DicBuilderTest.a");
+  std::istringstream sin_b(tsv);
+  hanal::DicBuilder::build_morph(sin_b, "DicBuilderTest.b");
+  std::istringstream profile("나다\t3\n\n다 나다\n");
+  hanal::DicBuilder::layout_morph("DicBuilderTest.b", profile);
+
+  auto value = [this] (std::string stem, const wchar_t* key) {
+    hanal::Trie trie;
+    trie.open(stem + ".trie");
+    std::string vals = read(stem + ".val");
+    std::string lens = read(stem + ".val.len");
+    auto val_idx = trie.find(key);
+    if (!val_idx) return std::wstring();
+    int offset = 0;
+    for (int idx = 0; idx < *val_idx; ++idx) offset += reinterpret_cast<const int16_t*>(lens.data())[idx];
+    return std::wstring(reinterpret_cast<const wchar_t*>(vals.data()) + offset);
+  };
+  for (auto key : {L"가", L"가나", L"가다", L"나", L"나다", L"다", L"가가"}) {
+    EXPECT_EQ(value("DicBuilderTest.a", key), value("DicBuilderTest.b", key));
+  }
+  hanal::Trie trie;
+  trie.open("DicBuilderTest.b.trie");
+  EXPECT_EQ(0, *trie.find(L"다"));    // found 5 times (from '다' and '나다')
+  EXPECT_EQ(1, *trie.find(L"나"));    // found 4 times. tie is broken by order of nodes
+  EXPECT_EQ(2, *trie.find(L"나다"));
+  EXPECT_EQ(3, *trie.find(L"가"));    // never found
+  EXPECT_EQ(read("DicBuilderTest.a.val").size(), read("DicBuilderTest.b.val").size());
+  std::string lens = read("DicBuilderTest.b.val.len");
+  std::string offs = read("DicBuilderTest.b.val.off").substr(sizeof(hanal::_val_off_header_t));
+  ASSERT_EQ(lens.size() / sizeof(int16_t) + 1, offs.size() / sizeof(int32_t));
+  for (int idx = 0; idx < lens.size() / sizeof(int16_t); ++idx) {    // offsets follow new order of values
+    EXPECT_EQ(reinterpret_cast<const int32_t*>(offs.data())[idx] + reinterpret_cast<const int16_t*>(lens.data())[idx],
+              reinterpret_cast<const int32_t*>(offs.data())[idx + 1]);
+  }
+
+  std::istringstream invalid_freq("나다\tmany\n");
+  EXPECT_THROW(hanal::DicBuilder::layout_morph("DicBuilderTest.b", invalid_freq), hanal::Except);
+}
+
+
+TEST_F(DicBuilderTest, build_state_feat) {
+  std::istringstream sin(
+      "STATE_FEATURES = {\n"
+      "  (0) BOS --> NNG: 1.5\n"
+      "  (1) S_0=. --> SF: 2.5\n"
+      "  (2) invalid line\n"
+      "  (3) BOS --> EC: 0.0\n"
+      "  (4) BOS --> NNG: -2.0\n"    // the last one wins
+      "}\n"
+      "  (5) EOS --> NNG: 1.0\n");
+  hanal::DicBuilder::build_state_feat(sin, "DicBuilderTest.a", 2, 1);
+  hanal::Trie trie;
+  trie.open("DicBuilderTest.a.trie");
+  EXPECT_FALSE(trie.find(L"ABOS"));    // zero weight has no value
+  EXPECT_EQ(0, *trie.find(L"VBOS"));    // 'A' + NNG
+  EXPECT_EQ(1, *trie.find(L"\\S_0=."));    // 'A' + SF
+  EXPECT_FALSE(trie.find(L"VEOS"));
+  std::string vals = read("DicBuilderTest.a.val");
+  EXPECT_EQ(std::vector<float>({-2.0f, 2.5f}),
+            std::vector<float>(reinterpret_cast<const float*>(vals.data()),
+                               reinterpret_cast<const float*>(vals.data() + vals.size())));
+
+  std::istringstream unknown_tag("STATE_FEATURES = {\n  (0) BOS --> XXX: 1.5\n}\n");
+  EXPECT_THROW(hanal::DicBuilder::build_state_feat(unknown_tag, "DicBuilderTest.a"), hanal::Except);
+}
@@ -0,0 +1,106 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+//////////////
+// includes //
+//////////////
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hanal/Jamo.hpp"
+
+
+/**
+ * test fixture for Jamo
+ */
+class JamoTest: public testing::Test {
+ protected:
+  /**
+   * @brief         split character into jamo string
+   * @param  wchar  wide character
+   * @return        (initial, medial, final) joined. absent one is omitted
+   */
+  std::wstring split(wchar_t wchar) {
+    auto split = hanal::Jamo::split(wchar);
+    std::wstring jamo;
+    for (wchar_t ch : {split.cho, split.jung, split.jong}) {
+      if (ch != L'\0') jamo += ch;
+    }
+    return jamo;
+  }
+};
+
+
+TEST_F(JamoTest, split) {
+  EXPECT_EQ(L"ㄱㅏ", split(L'가'));
+  EXPECT_EQ(L"ㅎㅣㅎ", split(L'힣'));
+  EXPECT_EQ(L"ㄷㅏㄺ", split(L'닭'));
+  EXPECT_EQ(L"ㅇㅢ", split(L'의'));
+  EXPECT_EQ(L"ㄳ", split(L'ㄳ'));    // consonant only
+  EXPECT_EQ(L"ㅘ", split(L'ㅘ'));    // vowel only
+  EXPECT_EQ(L"", split(L'A'));    // not Hangul
+  EXPECT_EQ(L"", split(L'ᄀ'));    // conjoining jamo is not Hangul (same to hangul.py)
+
+  EXPECT_EQ(L'ㄷ', hanal::Jamo::initial(L'닭'));
+  EXPECT_EQ(L'ㄺ', hanal::Jamo::final(L'닭'));
+  EXPECT_EQ(L'\0', hanal::Jamo::final(L'가'));
+
+  std::wstring text = L"한A글";
+  std::vector<hanal::Jamo::split_t> splits(text.size());
+  hanal::Jamo::split(text.c_str(), text.size(), splits.data());
+  EXPECT_EQ(L'ㅎ', splits[0].cho);
+  EXPECT_EQ(L'ㄴ', splits[0].jong);
+  EXPECT_EQ(L'\0', splits[1].cho);
+  EXPECT_EQ(L'ㄱ', splits[2].cho);
+  EXPECT_EQ(L'ㅡ', splits[2].jung);
+  EXPECT_EQ(L'ㄹ', splits[2].jong);
+
+  // every syllable is composed back from its jamo
+  const std::wstring choseong = L"ㄱㄲㄴㄷㄸㄹㅁㅂㅃㅅㅆㅇㅈㅉㅊㅋㅌㅍㅎ";
+  const std::wstring jungseong = L"ㅏㅐㅑㅒㅓㅔㅕㅖㅗㅘㅙㅚㅛㅜㅝㅞㅟㅠㅡㅢㅣ";
+  const std::wstring jongseong = L"ㄱㄲㄳㄴㄵㄶㄷㄹㄺㄻㄼㄽㄾㄿㅀㅁㅂㅄㅅㅆㅇㅈㅊㅋㅌㅍㅎ";
+  for (wchar_t wchar = L'가'; wchar <= L'힣'; ++wchar) {
+    auto split = hanal::Jamo::split(wchar);
+    int jong = (split.jong == L'\0') ? 0 : jongseong.find(split.jong) + 1;
+    EXPECT_EQ(wchar, L'가' + (choseong.find(split.cho) * 21 + jungseong.find(split.jung)) * 28 + jong);
+  }
+}
+
+
+TEST_F(JamoTest, compose) {
+  wchar_t syllable = L'\0';
+  EXPECT_EQ(2, hanal::Jamo::compose(L"\u1100\u1161", 2, &syllable));    // L+V
+  EXPECT_EQ(L'가', syllable);
+  EXPECT_EQ(3, hanal::Jamo::compose(L"\u1103\u1161\u11B0", 3, &syllable));    // L+V+T
+  EXPECT_EQ(L'닭', syllable);
+  EXPECT_EQ(3, hanal::Jamo::compose(L"\u1112\u1175\u11C2", 3, &syllable));
+  EXPECT_EQ(L'힣', syllable);
+  EXPECT_EQ(2, hanal::Jamo::compose(L"\u1100\u1161\u1100", 3, &syllable));    // next L is not T
+  EXPECT_EQ(L'가', syllable);
+  EXPECT_EQ(2, hanal::Jamo::compose(L"\u1100\u1161\u11B0", 2, &syllable));    // T out of size
+  EXPECT_EQ(0, hanal::Jamo::compose(L"\u1100", 1, &syllable));    // L only
+  EXPECT_EQ(0, hanal::Jamo::compose(L"\u1161\u11A8", 2, &syllable));    // V+T
+  EXPECT_EQ(0, hanal::Jamo::compose(L"가\u11A8", 2, &syllable));
+}
+
+
+TEST_F(JamoTest, features) {
+  EXPECT_EQ(hanal::Jamo::CIC, hanal::Jamo::features(L'가'));
+  EXPECT_EQ(0, hanal::Jamo::features(L'아'));    // 'ㅇ' is not initial consonant feature
+  EXPECT_EQ(hanal::Jamo::FC, hanal::Jamo::features(L'악'));
+  EXPECT_EQ(hanal::Jamo::CIC | hanal::Jamo::FC | hanal::Jamo::FC_RIEUL, hanal::Jamo::features(L'갈'));
+  EXPECT_EQ(hanal::Jamo::CIC | hanal::Jamo::FC, hanal::Jamo::features(L'닭'));    // 'ㄺ' is not 'ㄹ'
+  EXPECT_EQ(hanal::Jamo::CIC, hanal::Jamo::features(L'ㄴ'));
+  EXPECT_EQ(0, hanal::Jamo::features(L'ㅏ'));
+  EXPECT_EQ(0, hanal::Jamo::features(L'.'));
+
+  std::wstring text = L"먹었다.";
+  std::vector<uint8_t> feats(text.size());
+  hanal::Jamo::features(text.c_str(), text.size(), feats.data());
+  EXPECT_EQ(std::vector<uint8_t>({hanal::Jamo::CIC | hanal::Jamo::FC, hanal::Jamo::FC, hanal::Jamo::CIC, 0}),
+            feats);
+}
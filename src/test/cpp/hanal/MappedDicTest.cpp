@@ -0,0 +1,54 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+//////////////
+// includes //
+//////////////
+#include <algorithm>
+#include <map>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "hanal/MappedDic.hpp"
+
+
+extern std::map<std::string, std::string> prog_args;    // arguments passed to main program
+
+
+/**
+ * test fixture for MappedDic
+ */
+class MappedDicTest: public testing::Test {
+ protected:
+  virtual void SetUp() {
+    auto iter = prog_args.find("rsc-dir");
+    if (iter == prog_args.end()) FAIL() << "--rsc-dir argument required";
+    path = prog_args["rsc-dir"] + "/morph.trie";
+  }
+
+  std::string path;    ///< path of mapped file
+};
+
+
+TEST_F(MappedDicTest, residency) {
+  hanal::MappedDic<int32_t> plain;
+  ASSERT_NO_THROW(plain.open(path));
+
+  hanal::residency_t residency;
+  residency.populate = true;
+  residency.willneed = true;
+  residency.hugepage = true;
+  residency.random = true;
+  residency.mlock = true;
+  for (int i = 0; i < 3; ++i) {    // reopen while reading ahead
+    hanal::MappedDic<int32_t> resident;
+    ASSERT_NO_THROW(resident.open(path, false, residency));
+    ASSERT_EQ(plain.size(), resident.size());
+    EXPECT_TRUE(std::equal(plain.const_data(), plain.const_data() + plain.size(), resident.const_data()));
+    ASSERT_NO_THROW(resident.open(path, true, residency));    // private mode
+    EXPECT_EQ(plain.size(), resident.size());
+  }
+}
@@ -7,10 +7,18 @@
 //////////////
 // includes //
 //////////////
+#include <sys/stat.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
 #include <map>
 #include <string>
+#include <thread>    // NOLINT
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "hanal/DicBuilder.hpp"
 #include "hanal/MorphDic.hpp"
 
 
@@ -42,3 +50,222 @@ TEST_F(MorphDicTest, open_close) {
   EXPECT_THROW(morph_dic.open(rsc_dir + "/__not_existing_dir__"), hanal::Except);
 }
 
+
+TEST_F(MorphDicTest, binary_value) {
+  std::string bin_dir = "MorphDicTest.bin";    // in current directory
+  mkdir(bin_dir.c_str(), 0755);
+  for (auto name : {"/morph.trie", "/morph.val", "/morph.val.len"}) {
+    std::ifstream fin(rsc_dir + name, std::ios::binary);
+    std::ofstream fout(bin_dir + name, std::ios::binary);
+    fout << fin.rdbuf();
+  }
+  hanal::DicBuilder::compile_morph_val(bin_dir + "/morph");
+  EXPECT_THROW(hanal::DicBuilder::compile_morph_val(bin_dir + "/morph"), hanal::Except);    // compiled already
+
+  hanal::MorphDic text_dic;
+  text_dic.open(rsc_dir);
+  hanal::MorphDic bin_dic;
+  hanal::cache_option_t val_cache;
+  val_cache.budget = 1;    // only the last value is cached, so values are evicted and decoded again
+  bin_dic.open(bin_dir, false, hanal::residency_t(), val_cache);
+  std::ifstream len_file(rsc_dir + "/morph.val.len", std::ios::binary | std::ios::ate);
+  int val_num = len_file.tellg() / sizeof(int16_t);
+  for (int round = 0; round < 2; ++round) {
+    for (int idx = 0; idx < val_num; ++idx) {
+      auto text_val = text_dic.value(idx);
+      auto bin_val = bin_dic.value(idx);
+      ASSERT_EQ(text_val->size(), bin_val->size());
+      for (int anal_idx = 0; anal_idx < text_val->size(); ++anal_idx) {
+        EXPECT_EQ(text_dic.morph_table().str((*text_val)[anal_idx]),
+                  bin_dic.morph_table().str((*bin_val)[anal_idx]));
+      }
+    }
+  }
+  EXPECT_LT(0, bin_dic.cache_stat().evictions);
+  EXPECT_THROW(bin_dic.value(val_num), hanal::Except);
+  bin_dic.close();
+
+  // records out of sections are rejected when value is parsed
+  auto corrupt = [&] (size_t pos, const void* data, size_t size) {
+    std::fstream fout(bin_dir + "/morph.val", std::ios::binary | std::ios::in | std::ios::out);
+    fout.seekp(pos);
+    fout.write(reinterpret_cast<const char*>(data), size);
+  };
+  hanal::_morph_val_header_t header;
+  hanal::_val_rec_t val_rec;    // of the first value
+  hanal::_anal_rec_t anal_rec;    // of the first analysis result of the first value
+  std::ifstream fin(bin_dir + "/morph.val", std::ios::binary);
+  fin.read(reinterpret_cast<char*>(&header), sizeof(header));
+  fin.read(reinterpret_cast<char*>(&val_rec), sizeof(val_rec));
+  size_t anal_pos = sizeof(header) + header.val_num * sizeof(val_rec);
+  fin.seekg(anal_pos + val_rec.anal_start * sizeof(anal_rec));
+  fin.read(reinterpret_cast<char*>(&anal_rec), sizeof(anal_rec));
+  fin.close();
+  size_t morph_pos = anal_pos + header.anal_num * sizeof(anal_rec) + anal_rec.morph_start * sizeof(hanal::_morph_rec_t);
+  uint8_t invalid_tag = 0xFF;
+  corrupt(morph_pos + offsetof(hanal::_morph_rec_t, tag), &invalid_tag, sizeof(invalid_tag));
+  bin_dic.open(bin_dir);
+  EXPECT_THROW(bin_dic.value(0), hanal::Except);    // tag out of range
+  bin_dic.close();
+  hanal::_val_rec_t invalid_val_rec = val_rec;
+  invalid_val_rec.anal_start = 0xFFFFFFFF;
+  corrupt(sizeof(hanal::_morph_val_header_t), &invalid_val_rec, sizeof(invalid_val_rec));
+  bin_dic.open(bin_dir);
+  EXPECT_THROW(bin_dic.value(0), hanal::Except);    // analysis results out of range
+  bin_dic.close();
+  for (auto name : {"/morph.trie", "/morph.val", "/morph.val.len"}) std::remove((bin_dir + name).c_str());
+  std::remove(bin_dir.c_str());
+}
+
+
+TEST_F(MorphDicTest, value_offsets) {
+  std::string off_dir = "MorphDicTest.off";    // in current directory
+  mkdir(off_dir.c_str(), 0755);
+  for (auto name : {"/morph.trie", "/morph.val", "/morph.val.len"}) {
+    std::ifstream fin(rsc_dir + name, std::ios::binary);
+    std::ofstream fout(off_dir + name, std::ios::binary);
+    fout << fin.rdbuf();
+  }
+  hanal::MorphDic len_dic;    // offsets are summed from lengths
+  len_dic.open(off_dir);
+  hanal::DicBuilder::index_morph_val(off_dir + "/morph");
+  hanal::MorphDic off_dic;
+  off_dic.open(off_dir);
+  std::ifstream len_file(rsc_dir + "/morph.val.len", std::ios::binary | std::ios::ate);
+  int val_num = len_file.tellg() / sizeof(int16_t);
+  for (int idx = 0; idx < val_num; ++idx) {
+    auto len_val = len_dic.value(idx);
+    auto off_val = off_dic.value(idx);
+    ASSERT_EQ(len_val->size(), off_val->size());
+    for (int anal_idx = 0; anal_idx < len_val->size(); ++anal_idx) {
+      EXPECT_EQ(len_dic.morph_table().str((*len_val)[anal_idx]), off_dic.morph_table().str((*off_val)[anal_idx]));
+    }
+  }
+  EXPECT_THROW(off_dic.value(val_num), hanal::Except);
+  off_dic.close();
+
+  // offsets which do not match dictionary are ignored and summed from lengths
+  auto expect_fallback = [&] () {
+    ASSERT_NO_THROW(off_dic.open(off_dir));
+    auto len_val = len_dic.value(val_num - 1);
+    auto off_val = off_dic.value(val_num - 1);
+    ASSERT_EQ(len_val->size(), off_val->size());
+    EXPECT_EQ(len_dic.morph_table().str((*len_val)[0]), off_dic.morph_table().str((*off_val)[0]));
+    EXPECT_THROW(off_dic.value(val_num), hanal::Except);
+    off_dic.close();
+  };
+  std::ofstream(off_dir + "/morph.val.off", std::ios::binary | std::ios::app).write("\0\0\0\0", 4);
+  expect_fallback();    // size does not match
+  std::ofstream(off_dir + "/morph.val.off", std::ios::binary).write("\0\0\0\0", 4);
+  expect_fallback();    // no header (offsets file of old format)
+  {
+    std::ofstream fout(off_dir + "/morph.val.off", std::ios::binary);
+    hanal::_val_off_header_t header;
+    header.magic = hanal::MorphDic::VAL_OFF_MAGIC;
+    header.val_num = val_num - 1;    // stale offsets of the other dictionary
+    header.val_size = 0;
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::vector<int32_t> offsets(val_num, 0);
+    fout.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(int32_t));
+  }
+  expect_fallback();
+
+  // corrupt offset is rejected when its value is parsed
+  hanal::DicBuilder::index_morph_val(off_dir + "/morph");
+  {
+    std::fstream fout(off_dir + "/morph.val.off", std::ios::binary | std::ios::in | std::ios::out);
+    int32_t negative = -5;
+    fout.seekp(sizeof(hanal::_val_off_header_t) + sizeof(int32_t));
+    fout.write(reinterpret_cast<const char*>(&negative), sizeof(negative));
+  }
+  off_dic.open(off_dir);
+  EXPECT_THROW(off_dic.value(1), hanal::Except);
+  off_dic.close();
+
+  // without lengths, negative number of values in header is not matched
+  std::remove((off_dir + "/morph.val.len").c_str());
+  {
+    std::ifstream val_file(off_dir + "/morph.val", std::ios::binary | std::ios::ate);
+    std::ofstream fout(off_dir + "/morph.val.off", std::ios::binary);
+    hanal::_val_off_header_t header;
+    header.magic = hanal::MorphDic::VAL_OFF_MAGIC;
+    header.val_num = -1;
+    header.val_size = val_file.tellg() / sizeof(wchar_t);
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+  EXPECT_THROW(off_dic.open(off_dir), hanal::Except);    // no lengths to fall back on
+
+  for (auto name : {"/morph.trie", "/morph.val", "/morph.val.len", "/morph.val.off"}) {
+    std::remove((off_dir + name).c_str());
+  }
+  std::remove(off_dir.c_str());
+}
+
+
+TEST_F(MorphDicTest, concurrent_value) {
+  std::ifstream len_file(rsc_dir + "/morph.val.len", std::ios::binary | std::ios::ate);
+  int val_num = len_file.tellg() / sizeof(int16_t);
+  hanal::MorphDic morph_dic;
+  morph_dic.open(rsc_dir);
+  std::vector<std::thread> threads;
+  std::vector<std::vector<const void*>> values(8, std::vector<const void*>(val_num, nullptr));
+  hanal::MorphDic bounded_dic;
+  hanal::cache_option_t val_cache;
+  val_cache.budget = 1;
+  bounded_dic.open(rsc_dir, false, hanal::residency_t(), val_cache);
+  for (int thread_idx = 0; thread_idx < values.size(); ++thread_idx) {
+    threads.emplace_back([&, thread_idx] () {
+      for (int i = 0; i < val_num; ++i) {
+        int idx = (thread_idx % 2 == 0) ? i : val_num - 1 - i;    // half of threads in reverse order
+        values[thread_idx][idx] = morph_dic.value(idx).get();
+        auto bounded_val = bounded_dic.value(idx);    // evicted concurrently
+        EXPECT_EQ(values[thread_idx][idx] ? morph_dic.value(idx)->size() : 0, bounded_val->size());
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  for (int thread_idx = 1; thread_idx < values.size(); ++thread_idx) {
+    EXPECT_EQ(values[0], values[thread_idx]);    // every value is parsed once and shared
+  }
+  for (int idx = 0; idx < val_num; ++idx) EXPECT_FALSE(morph_dic.value(idx)->empty());
+  EXPECT_EQ(0, morph_dic.cache_stat().evictions);
+  EXPECT_LT(0, bounded_dic.cache_stat().evictions);
+}
+
+
+TEST_F(MorphDicTest, bounded_cache) {
+  hanal::MorphDic unbounded_dic;
+  unbounded_dic.open(rsc_dir);
+  hanal::MorphDic morph_dic;
+  hanal::cache_option_t val_cache;
+  val_cache.budget = 1;    // only the last value is cached
+  val_cache.warm_up = 10;
+  morph_dic.open(rsc_dir, false, hanal::residency_t(), val_cache);
+  auto stat = morph_dic.cache_stat();
+  EXPECT_EQ(0, stat.hits);
+  EXPECT_EQ(10, stat.misses);    // warmed up
+  morph_dic.value(9);
+  EXPECT_EQ(1, morph_dic.cache_stat().hits);
+  EXPECT_EQ(9, morph_dic.cache_stat().evictions);
+
+  std::ifstream len_file(rsc_dir + "/morph.val.len", std::ios::binary | std::ios::ate);
+  int val_num = len_file.tellg() / sizeof(int16_t);
+  auto held = morph_dic.value(0);
+  std::string held_str = morph_dic.morph_table().str(held->at(0));
+  for (int round = 0; round < 2; ++round) {
+    for (int idx = 0; idx < val_num; ++idx) {
+      auto expected = unbounded_dic.value(idx);
+      auto actual = morph_dic.value(idx);    // parsed again after eviction
+      ASSERT_EQ(expected->size(), actual->size());
+      for (int anal_idx = 0; anal_idx < expected->size(); ++anal_idx) {
+        EXPECT_EQ(unbounded_dic.morph_table().str((*expected)[anal_idx]),
+                  morph_dic.morph_table().str((*actual)[anal_idx]));
+      }
+    }
+  }
+  EXPECT_EQ(held_str, morph_dic.morph_table().str(held->at(0)));    // evicted value is alive while held
+  stat = morph_dic.cache_stat();
+  EXPECT_LT(0, stat.evictions);
+  EXPECT_EQ(val_num, unbounded_dic.cache_stat().misses);
+  EXPECT_GT(unbounded_dic.cache_stat().bytes, stat.bytes);
+}
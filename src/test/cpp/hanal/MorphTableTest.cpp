@@ -0,0 +1,54 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+//////////////
+// includes //
+//////////////
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hanal/MorphTable.hpp"
+
+
+TEST(MorphTableTest, intern) {
+  hanal::MorphTable table;
+  auto ga_vv = table.intern(L"가다", 1, hanal::SejongTag::VV);    // not necessarily zero terminated
+  auto ga_jks = table.intern(L"가", 1, hanal::SejongTag::JKS);
+  EXPECT_NE(ga_vv, ga_jks);
+  EXPECT_EQ(ga_vv, table.intern(L"가", 1, hanal::SejongTag::VV));    // interned once
+  EXPECT_EQ(2, table.size());
+  EXPECT_EQ(std::wstring(L"가"), table.lex(ga_vv));
+  EXPECT_EQ(hanal::SejongTag::JKS, table.tag(ga_jks));
+  EXPECT_EQ("가/VV + 가/JKS", table.str(std::vector<hanal::morph_id_t>({ga_vv, ga_jks})));
+
+  std::vector<hanal::morph_id_t> ids;    // over a few blocks and lexical form chunks
+  for (int num = 0; num < 100000; ++num) {
+    ids.emplace_back(table.intern(std::to_wstring(num).c_str(), std::to_wstring(num).length(), hanal::SejongTag::SN));
+  }
+  for (int num = 0; num < 100000; num += 997) EXPECT_EQ(std::to_wstring(num), table.lex(ids[num]));
+  EXPECT_EQ(std::wstring(L"가"), table.lex(ga_vv));
+  std::wstring long_lex(100000, L'가');    // longer than a lexical form chunk
+  auto long_id = table.intern(long_lex.c_str(), long_lex.length(), hanal::SejongTag::NNG);
+  EXPECT_EQ(long_lex, table.lex(long_id));
+  EXPECT_EQ(long_id, table.intern(long_lex.c_str(), long_lex.length(), hanal::SejongTag::NNG));
+
+  table.clear();
+  EXPECT_EQ(0, table.size());
+}
+
+
+TEST(MorphTableTest, local) {
+  hanal::MorphTable base;
+  auto nng = base.intern(L"사과", 2, hanal::SejongTag::NNG);
+  hanal::MorphTable local(&base);
+  auto nnp = local.intern(L"사과", 2, hanal::SejongTag::NNP);
+  EXPECT_NE(0, nnp & hanal::MorphTable::LOCAL_BIT);
+  EXPECT_EQ(0, nng & hanal::MorphTable::LOCAL_BIT);
+  EXPECT_EQ("사과/NNG + 사과/NNP", local.str(std::vector<hanal::morph_id_t>({nng, nnp})));    // base is looked up
+  EXPECT_EQ(1, base.size());
+  EXPECT_EQ(1, local.size());
+}
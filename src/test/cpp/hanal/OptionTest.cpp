@@ -0,0 +1,54 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+//////////////
+// includes //
+//////////////
+#include "gtest/gtest.h"
+#include "hanal/Except.hpp"
+#include "hanal/Option.hpp"
+
+
+TEST(OptionTest, parse) {
+  hanal::Option opt("");
+  EXPECT_EQ(1, opt.word_merge);
+  EXPECT_TRUE(opt.anal_back);
+  EXPECT_FALSE(opt.aho_corasick);
+
+  hanal::Option opt2("word_merge=2, anal_back=false aho_corasick");
+  EXPECT_EQ(2, opt2.word_merge);
+  EXPECT_FALSE(opt2.anal_back);
+  EXPECT_TRUE(opt2.aho_corasick);
+
+  auto overrided = opt2.override("anal_back=1");
+  EXPECT_EQ(2, overrided.word_merge);
+  EXPECT_TRUE(overrided.anal_back);
+  EXPECT_FALSE(opt2.anal_back);    // original is not changed
+  EXPECT_THROW(opt2.override("aho_corasick=false"), hanal::Except);    // open only
+  EXPECT_THROW(opt2.override("prefetch"), hanal::Except);
+  EXPECT_THROW(opt2.override("val_cache_mb=1"), hanal::Except);
+
+  hanal::Option opt3("populate,random=true,prefetch");
+  EXPECT_TRUE(opt3.residency.populate);
+  EXPECT_TRUE(opt3.residency.random);
+  EXPECT_TRUE(opt3.residency.willneed);    // prefetch is alias of willneed
+  EXPECT_FALSE(opt3.residency.hugepage);
+  EXPECT_FALSE(opt3.residency.mlock);
+  EXPECT_EQ(0, opt3.val_cache.budget);
+  EXPECT_EQ(0, opt3.val_cache.warm_up);
+  EXPECT_TRUE(hanal::Option("willneed,prefetch=false").residency.willneed);    // alias does not turn it off
+  EXPECT_FALSE(hanal::Option("prefetch=false").residency.willneed);
+
+  hanal::Option opt4("val_cache_mb=64 val_cache_warm_up=1000");
+  EXPECT_EQ(64 * 1024 * 1024, opt4.val_cache.budget);
+  EXPECT_EQ(1000, opt4.val_cache.warm_up);
+
+  EXPECT_THROW(hanal::Option("__unknown__=1"), hanal::Except);
+  EXPECT_THROW(hanal::Option("word_merge=two"), hanal::Except);
+  EXPECT_THROW(hanal::Option("anal_back=yes"), hanal::Except);
+  EXPECT_THROW(hanal::Option("val_cache_mb=-1"), hanal::Except);
+  EXPECT_THROW(hanal::Option("val_cache_warm_up=many"), hanal::Except);
+}
@@ -0,0 +1,82 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+//////////////
+// includes //
+//////////////
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hanal/CharBuffer.hpp"
+#include "hanal/SentSplitter.hpp"
+
+
+/**
+ * test fixture for SentSplitter
+ */
+class SentSplitterTest: public testing::Test {
+ protected:
+  /**
+   * @brief       split document into sentences
+   * @param  doc  UTF-8 document
+   * @return      sentences (sub-strings of document)
+   */
+  std::vector<std::string> split(const std::string& doc) {
+    chars.characterize(doc.c_str());
+    std::vector<std::string> sents;
+    for (auto& sent : hanal::SentSplitter::split(chars)) {
+      sents.emplace_back(doc.substr(sent.begin, sent.end - sent.begin));
+    }
+    return sents;
+  }
+
+  hanal::CharBuffer chars;    ///< characters of document
+};
+
+
+TEST_F(SentSplitterTest, split) {
+  typedef std::vector<std::string> sents_t;
+  EXPECT_EQ(sents_t(), split(""));
+  EXPECT_EQ(sents_t(), split(" \n "));
+  EXPECT_EQ(sents_t({u8"아버지가 방에 들어가신다."}), split(u8" 아버지가 방에 들어가신다. "));
+  EXPECT_EQ(sents_t({u8"정말?!", u8"\"그래요…\"", u8"끝"}), split(u8"정말?! \"그래요…\"\n끝"));
+  EXPECT_EQ(sents_t({u8"원주율은 3.14 입니다."}), split(u8"원주율은 3.14 입니다."));    // period in word
+  EXPECT_EQ(sents_t({u8"마침표 없는 문장"}), split(u8"마침표 없는 문장"));
+
+  // character spans
+  chars.characterize(u8"가나. 다라.");
+  hanal::SentSplitter splitter(chars);
+  hanal::SentSplitter::sent_t sent;
+  ASSERT_TRUE(splitter.next(&sent));
+  EXPECT_EQ(0, sent.char_idx);
+  EXPECT_EQ(3, sent.char_end);
+  ASSERT_TRUE(splitter.next(&sent));
+  EXPECT_EQ(3, sent.char_idx);
+  EXPECT_EQ(6, sent.char_end);
+  EXPECT_EQ(8, sent.begin);
+  EXPECT_EQ(15, sent.end);
+  EXPECT_EQ(4, sent.cp_begin);
+  EXPECT_EQ(7, sent.cp_end);
+  EXPECT_FALSE(splitter.next(&sent));
+
+  // code point offsets are same to code unit ones of UTF-32 text
+  chars.characterize(U"가나. 다라.");
+  auto sents = hanal::SentSplitter::split(chars);
+  ASSERT_EQ(2, sents.size());
+  EXPECT_EQ(4, sents[1].begin);
+  EXPECT_EQ(4, sents[1].cp_begin);
+  EXPECT_EQ(7, sents[1].cp_end);
+
+  // surrogate pairs of UTF-16 text are counted as one code point
+  chars.characterize(u"\U0001F600가. \U0001F600나\U0001F600.");
+  sents = hanal::SentSplitter::split(chars);
+  ASSERT_EQ(2, sents.size());
+  EXPECT_EQ(5, sents[1].begin);
+  EXPECT_EQ(11, sents[1].end);
+  EXPECT_EQ(4, sents[1].cp_begin);
+  EXPECT_EQ(8, sents[1].cp_end);
+}
@@ -7,14 +7,20 @@
 //////////////
 // includes //
 //////////////
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <map>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "boost/log/trivial.hpp"
 #include "gtest/gtest.h"
 #include "hanal/Except.hpp"
 #include "hanal/Trie.hpp"
+#include "hanal/TrieBuilder.hpp"
 
 
 extern std::map<std::string, std::string> prog_args;    // arguments passed to main program
@@ -34,6 +40,35 @@ class TrieTest: public testing::Test {
     ASSERT_NO_THROW(state_feat_trie.open(state_feat_trie_path)) << "state_feat_trie_path: " << state_feat_trie_path;
   }
 
+  /**
+   * @brief   number of values of morph_trie (from size of morph.val.len)
+   */
+  int morph_val_num() {
+    std::ifstream len_file(prog_args["rsc-dir"] + "/morph.val.len", std::ios::binary | std::ios::ate);
+    return len_file.tellg() / sizeof(int16_t);
+  }
+
+  /**
+   * @brief          expect same results of morph_trie (legacy format) and converted one
+   * @param  trie    converted morph trie
+   */
+  void expect_same_to_legacy(const hanal::Trie& trie) {
+    for (auto key : {L"acceleration", L"a", L"accel", L"acceleratio", L"__not_found_key__", L"뷁", L""}) {
+      EXPECT_EQ(morph_trie.find(key), trie.find(key)) << key;
+    }
+    for (auto text : {L"accelerations", L"acc", L"뷁", L""}) {
+      auto matches = morph_trie.search_common_prefix_matches(text);
+      auto conv_matches = trie.search_common_prefix_matches(text);
+      ASSERT_EQ(matches.size(), conv_matches.size()) << text;
+      auto conv_match = conv_matches.begin();
+      for (auto& match : matches) {
+        EXPECT_EQ(match.len, conv_match->len);
+        EXPECT_EQ(match.val_idx, conv_match->val_idx);
+        ++conv_match;
+      }
+    }
+  }
+
   hanal::Trie morph_trie;
   hanal::Trie state_feat_trie;
   std::string morph_trie_path;    ///< path for morphemes morph_trie
@@ -52,6 +87,10 @@ TEST_F(TrieTest, open_close) {
 
   EXPECT_THROW(morph_trie.open(prog_args["rsc-dir"]), hanal::Except);    // directory, not file
   EXPECT_THROW(state_feat_trie.open(prog_args["rsc-dir"] + "__not_existing_file__"), hanal::Except);
+
+  std::ofstream("TrieTest.tiny", std::ios::binary).write("\0\0\0\0", 4);    // smaller than a node
+  EXPECT_THROW(morph_trie.open("TrieTest.tiny"), hanal::Except);
+  std::remove("TrieTest.tiny");
 }
 
 
@@ -93,6 +132,24 @@ TEST_F(TrieTest, search_all) {
               morph_trie.search_common_prefix_matches(std::wstring(text)).size());
   }
 
+  // length limited search (not zero terminated text)
+  auto limited_matches = morph_trie.search_common_prefix_matches(text, 5);
+  int limited_num = 0;
+  for (auto& match : matches) {
+    if (match.len <= 5) limited_num += 1;
+  }
+  EXPECT_EQ(limited_num, limited_matches.size());
+  for (auto& match : limited_matches) EXPECT_GE(5, match.len);
+  EXPECT_EQ(0, morph_trie.search_common_prefix_matches(text, 0).size());
+
+  // span in exact sized buffer. nothing after the span is read (checked by address sanitizer)
+  std::unique_ptr<wchar_t[]> span(new wchar_t[5]);
+  std::copy(text, text + 5, span.get());
+  auto span_matches = morph_trie.search_common_prefix_matches(span.get(), 5);
+  EXPECT_EQ(limited_matches.size(), span_matches.size());
+  EXPECT_EQ(limited_num, morph_trie.search_common_prefix_matches(span.get(), 5,
+                                                                 [] (const hanal::Trie::match_t&) {}));
+
   matches = morph_trie.search_common_prefix_matches(L"뷁");
   EXPECT_EQ(0, matches.size());
   matches = morph_trie.search_common_prefix_matches(L"");
@@ -100,3 +157,147 @@ TEST_F(TrieTest, search_all) {
 
   EXPECT_THROW(morph_trie.search_common_prefix_matches(nullptr), hanal::Except);
 }
+
+
+TEST_F(TrieTest, search_without_allocation) {
+  std::wstring text = L"accelerations";
+  auto matches = morph_trie.search_common_prefix_matches(text);
+  std::vector<hanal::Trie::match_t> visited;
+  int len = text.size();
+  EXPECT_EQ(matches.size(), morph_trie.search_common_prefix_matches(text.c_str(), len,
+      [&visited] (const hanal::Trie::match_t& match) { visited.emplace_back(match); }));
+  EXPECT_EQ(matches.size(), visited.size());
+
+  hanal::Trie::match_t buffer[8];
+  EXPECT_EQ(matches.size(), morph_trie.search_common_prefix_matches(text.c_str(), len, buffer, 8));
+  auto iter = matches.begin();
+  for (int idx = 0; idx < visited.size() && iter != matches.end(); ++idx, ++iter) {
+    EXPECT_EQ(iter->len, visited[idx].len);
+    EXPECT_EQ(iter->val_idx, visited[idx].val_idx);
+    EXPECT_EQ(iter->len, buffer[idx].len);
+    EXPECT_EQ(iter->val_idx, buffer[idx].val_idx);
+  }
+
+  // search stops when buffer is full
+  EXPECT_EQ(2, morph_trie.search_common_prefix_matches(text.c_str(), len, buffer, 2));
+  EXPECT_EQ(matches.begin()->len, buffer[0].len);
+  EXPECT_EQ(0, morph_trie.search_common_prefix_matches(text.c_str(), len, buffer, 0));
+  EXPECT_THROW(morph_trie.search_common_prefix_matches(nullptr, 0, buffer, 8), hanal::Except);
+}
+
+
+TEST_F(TrieTest, cursor) {
+  std::wstring text = L"accelerations";
+  auto matches = morph_trie.search_common_prefix_matches(text);
+  auto iter = matches.begin();
+  auto cursor = morph_trie.cursor();
+  EXPECT_TRUE(cursor.is_valid());
+  EXPECT_EQ(0, cursor.depth());
+  hanal::TrieCursor branch = cursor;
+  for (auto ch : text) {
+    if (!cursor.step(ch)) break;
+    if (cursor.depth() == 3) branch = cursor.clone();
+    if (cursor.value() < 0) continue;
+    ASSERT_TRUE(iter != matches.end());
+    EXPECT_EQ(iter->len, cursor.depth());
+    EXPECT_EQ(iter->val_idx, cursor.value());
+    ++iter;
+  }
+  EXPECT_TRUE(iter == matches.end());
+
+  // clone walks independently from the node where it is cloned
+  EXPECT_EQ(3, branch.depth());
+  EXPECT_TRUE(branch.step(L'e'));
+  EXPECT_FALSE(branch.step(L'뷁'));
+  EXPECT_FALSE(branch.is_valid());
+  EXPECT_EQ(-1, branch.value());
+  EXPECT_FALSE(branch.step(L'l'));    // invalid cursor does not step any more
+  EXPECT_EQ(4, branch.depth());
+}
+
+
+TEST_F(TrieTest, double_array) {
+  std::string morph_da_path = "TrieTest.morph.da.trie";    // in current directory
+  std::string state_feat_da_path = "TrieTest.state_feat.da.trie";
+  ASSERT_NO_THROW(hanal::TrieBuilder::to_double_array(morph_trie_path, morph_da_path));
+  ASSERT_NO_THROW(hanal::TrieBuilder::to_double_array(state_feat_trie_path, state_feat_da_path));
+  hanal::Trie morph_da;
+  hanal::Trie state_feat_da;
+  ASSERT_NO_THROW(morph_da.open(morph_da_path));
+  ASSERT_NO_THROW(state_feat_da.open(state_feat_da_path));
+  EXPECT_EQ(hanal::Trie::Format::LEGACY, morph_trie.format());
+  EXPECT_EQ(hanal::Trie::Format::DOUBLE_ARRAY, morph_da.format());
+
+  expect_same_to_legacy(morph_da);
+  EXPECT_EQ(state_feat_trie.find(L"VBOS"), state_feat_da.find(L"VBOS"));
+  EXPECT_TRUE(state_feat_da.find(L"VBOS") != boost::none);
+
+  EXPECT_THROW(hanal::TrieBuilder::to_double_array(morph_da_path, morph_da_path + ".2"), hanal::Except);
+  morph_da.close();
+  state_feat_da.close();
+  std::remove(morph_da_path.c_str());
+  std::remove(state_feat_da_path.c_str());
+}
+
+
+TEST_F(TrieTest, packed) {
+  std::string morph_packed_path = "TrieTest.morph.packed.trie";    // in current directory
+  std::string state_feat_packed_path = "TrieTest.state_feat.packed.trie";
+  ASSERT_NO_THROW(hanal::TrieBuilder::to_packed(morph_trie_path, morph_packed_path));
+  ASSERT_NO_THROW(hanal::TrieBuilder::to_packed(state_feat_trie_path, state_feat_packed_path));
+  hanal::Trie morph_packed;
+  hanal::Trie state_feat_packed;
+  ASSERT_NO_THROW(morph_packed.open(morph_packed_path));
+  ASSERT_NO_THROW(state_feat_packed.open(state_feat_packed_path));
+  EXPECT_EQ(hanal::Trie::Format::PACKED, morph_packed.format());
+  EXPECT_EQ(-1, morph_trie.value_num());    // not recorded in legacy format
+  EXPECT_EQ(morph_val_num(), morph_packed.value_num());
+
+  expect_same_to_legacy(morph_packed);
+  EXPECT_EQ(state_feat_trie.find(L"VBOS"), state_feat_packed.find(L"VBOS"));
+  EXPECT_TRUE(state_feat_packed.find(L"VBOS") != boost::none);
+
+  EXPECT_THROW(hanal::TrieBuilder::to_packed(morph_packed_path, morph_packed_path + ".2"), hanal::Except);
+  morph_packed.close();
+  state_feat_packed.close();
+  std::remove(morph_packed_path.c_str());
+  std::remove(state_feat_packed_path.c_str());
+}
+
+
+TEST_F(TrieTest, dawg) {
+  std::string morph_dawg_path = "TrieTest.morph.dawg.trie";    // in current directory
+  std::string state_feat_dawg_path = "TrieTest.state_feat.dawg.trie";
+  ASSERT_NO_THROW(hanal::TrieBuilder::to_dawg(morph_trie_path, morph_dawg_path));
+  ASSERT_NO_THROW(hanal::TrieBuilder::to_dawg(state_feat_trie_path, state_feat_dawg_path));
+  hanal::Trie morph_dawg;
+  hanal::Trie state_feat_dawg;
+  ASSERT_NO_THROW(morph_dawg.open(morph_dawg_path));
+  ASSERT_NO_THROW(state_feat_dawg.open(state_feat_dawg_path));
+  EXPECT_EQ(hanal::Trie::Format::DAWG, morph_dawg.format());
+  EXPECT_EQ(morph_val_num(), morph_dawg.value_num());
+
+  expect_same_to_legacy(morph_dawg);
+  EXPECT_EQ(state_feat_trie.find(L"VBOS"), state_feat_dawg.find(L"VBOS"));
+  EXPECT_TRUE(state_feat_dawg.find(L"VBOS") != boost::none);
+
+  // cursor accumulates weights along the path
+  auto cursor = morph_dawg.cursor();
+  for (auto ch : std::wstring(L"accel")) cursor.step(ch);
+  EXPECT_EQ(*morph_trie.find(L"accel"), cursor.value());
+
+  EXPECT_THROW(hanal::TrieBuilder::to_dawg(morph_dawg_path, morph_dawg_path + ".2"), hanal::Except);
+  morph_dawg.close();
+
+  // negative number of values is rejected
+  {
+    std::fstream fout(morph_dawg_path, std::ios::binary | std::ios::in | std::ios::out | std::ios::ate);
+    int32_t negative = -1;
+    fout.seekp(static_cast<int64_t>(fout.tellp()) - (morph_val_num() + 1) * sizeof(int32_t));
+    fout.write(reinterpret_cast<const char*>(&negative), sizeof(negative));
+  }
+  EXPECT_THROW(morph_dawg.open(morph_dawg_path), hanal::Except);
+  state_feat_dawg.close();
+  std::remove(morph_dawg_path.c_str());
+  std::remove(state_feat_dawg_path.c_str());
+}
@@ -0,0 +1,103 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+//////////////
+// includes //
+//////////////
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hanal/Except.hpp"
+#include "hanal/Utf8.hpp"
+
+
+/**
+ * test fixture for Utf8
+ */
+class Utf8Test: public testing::Test {
+ protected:
+  /**
+   * @brief        decode text
+   * @param  text  UTF-8 text
+   * @return       decoded wide string
+   */
+  std::wstring decode(const std::string& text) {
+    wchars.clear();
+    offsets.clear();
+    hanal::Utf8::decode(text.c_str(), text.c_str() + text.size(), &wchars, &offsets);
+    return std::wstring(wchars.begin(), wchars.end());
+  }
+
+  /**
+   * @brief        scan words
+   * @param  text  UTF-8 text
+   * @return       words (sub-strings of text)
+   */
+  std::vector<std::string> scan_words(const std::string& text) {
+    hanal::Utf8::scan_words(text.c_str(), text.c_str() + text.size(), &spans);
+    std::vector<std::string> words;
+    for (auto& span : spans) words.emplace_back(text.substr(span.begin, span.end - span.begin));
+    return words;
+  }
+
+  std::vector<wchar_t> wchars;    ///< decoded characters
+  std::vector<int> offsets;    ///< offsets of decoded characters
+  std::vector<hanal::Utf8::span_t> spans;    ///< spans of words
+};
+
+
+TEST_F(Utf8Test, decode) {
+  EXPECT_EQ(L"A À　가\U0001F600", decode(u8"A À　가\U0001F600"));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 4, 7, 10}), offsets);
+  EXPECT_EQ(L"", decode(""));
+  EXPECT_EQ(0, offsets.size());
+
+  // long enough to pass through vectorized paths (ASCII and 3-byte characters)
+  std::wstring wtext = L"0123456789abcdefghijklmnopqrstuvwxyz 가나다라마바사아자차카타파하 àÿ　一힣 end of text";
+  std::string text = u8"0123456789abcdefghijklmnopqrstuvwxyz 가나다라마바사아자차카타파하 àÿ　一힣 end of text";
+  EXPECT_EQ(wtext, decode(text));
+  int offset = 0;
+  for (int idx = 0; idx < wtext.size(); ++idx) {
+    EXPECT_EQ(offset, offsets[idx]);
+    offset += (wtext[idx] < 0x80) ? 1 : ((wtext[idx] < 0x800) ? 2 : 3);
+  }
+
+  EXPECT_THROW(decode("\xFE"), hanal::Except);    // invalid lead byte
+  EXPECT_THROW(decode("\xEA\xB0"), hanal::Except);    // truncated
+  EXPECT_THROW(decode("\xC0\xAF"), hanal::Except);    // overlong
+  EXPECT_THROW(decode("\xED\xA0\x80"), hanal::Except);    // surrogate
+  EXPECT_THROW(decode("0123456789abcdef\xEA\xB0\xEA\xB0\x80\xEA\xB0\x80\xEA\xB0\x80\xEA\xB0\x80"), hanal::Except);
+}
+
+
+TEST_F(Utf8Test, scan_words) {
+  typedef std::vector<std::string> words_t;
+  EXPECT_EQ(words_t(), scan_words(""));
+  EXPECT_EQ(words_t(), scan_words(u8" \t\r\n\v　"));
+  EXPECT_EQ(words_t({u8"가"}), scan_words(u8"가"));
+  EXPECT_EQ(words_t({u8"아버지가", u8"방에", u8"들어가신다."}), scan_words(u8" 아버지가　방에\t들어가신다.\n"));
+  EXPECT_EQ(words_t({u8"\f", u8"。、"}), scan_words(u8"\f 。、"));    // form feed and other CJK symbols
+
+  // ideographic spaces and word boundaries at every position of 16 bytes block
+  for (int pad = 0; pad < 20; ++pad) {
+    std::string prefix(pad, 'a');
+    words_t expected({u8"가나다", u8"라마", u8"바사아자차카타파하", "end"});
+    if (pad > 0) expected.insert(expected.begin(), prefix);
+    EXPECT_EQ(expected, scan_words(prefix + u8"　가나다 　 라마\t바사아자차카타파하 end"));
+    EXPECT_EQ(pad > 0 ? words_t({prefix}) : words_t(), scan_words(u8"　　　" + prefix + u8"　 "));
+  }
+}
+
+
+TEST_F(Utf8Test, decode_char) {
+  const char* text = u8"가";
+  wchar_t wchar = L'\0';
+  EXPECT_EQ(3, hanal::Utf8::decode_char(text, text + 3, &wchar));
+  EXPECT_EQ(L'가', wchar);
+  EXPECT_EQ(0, hanal::Utf8::decode_char(text, text + 2, &wchar));    // truncated
+  EXPECT_EQ(0, hanal::Utf8::decode_char(text, text, &wchar));    // empty
+}
@@ -8,7 +8,7 @@
 // includes //
 //////////////
 #include "gtest/gtest.h"
-#include "hanal/Char.hpp"
+#include "hanal/CharBuffer.hpp"
 #include "hanal/Except.hpp"
 #include "hanal/Word.hpp"
 
@@ -22,61 +22,84 @@ class WordTest: public testing::Test {
 
 TEST_F(WordTest, tokenize) {
   const char* text1 = u8" a \t\u00E0\u00FF\u3000\uD558\uD558\uD558 \n";    // "a", "àÿ", "하하하"
-  auto words1 = hanal::Word::tokenize(text1);
+  hanal::CharBuffer chars1;
+  auto words1 = hanal::Word::tokenize(text1, &chars1);
   EXPECT_EQ(3, words1.size());
-  EXPECT_EQ(1, words1[0]->chars.size());    // "a"
-  EXPECT_EQ(0, words1[0]->char_idx);
-  EXPECT_EQ(text1 + 1, words1[0]->chars.front()->start);
-  EXPECT_EQ(text1 + 2, words1[0]->chars.back()->end);
-  EXPECT_EQ(2, words1[1]->chars.size());    // "àÿ"
-  EXPECT_EQ(1, words1[1]->char_idx);
-  EXPECT_EQ(text1 + 4, words1[1]->chars.front()->start);
-  EXPECT_EQ(text1 + 8, words1[1]->chars.back()->end);
-  EXPECT_EQ(3, words1[2]->chars.size());    // "하하하"
-  EXPECT_EQ(3, words1[2]->char_idx);
-  EXPECT_EQ(text1 + 11, words1[2]->chars.front()->start);
-  EXPECT_EQ(text1 + 20, words1[2]->chars.back()->end);
+  EXPECT_EQ(1, words1[0].size());    // "a"
+  EXPECT_EQ(0, words1[0].char_idx);
+  EXPECT_EQ(1, words1[0].begin);
+  EXPECT_EQ(2, words1[0].end);
+  EXPECT_EQ(2, words1[1].size());    // "àÿ"
+  EXPECT_EQ(1, words1[1].char_idx);
+  EXPECT_EQ(4, words1[1].begin);
+  EXPECT_EQ(8, words1[1].end);
+  EXPECT_EQ(3, words1[2].size());    // "하하하"
+  EXPECT_EQ(3, words1[2].char_idx);
+  EXPECT_EQ(11, words1[2].begin);
+  EXPECT_EQ(20, words1[2].end);
 
   const char* text2 = "";
-  auto words2 = hanal::Word::tokenize(text2);
+  hanal::CharBuffer chars2;
+  auto words2 = hanal::Word::tokenize(text2, &chars2);
   EXPECT_EQ(0, words2.size());
 
   const char* text3 = " \v\r";
-  auto words3 = hanal::Word::tokenize(text3);
+  hanal::CharBuffer chars3;
+  auto words3 = hanal::Word::tokenize(text3, &chars3);
   EXPECT_EQ(0, words3.size());
 
-  EXPECT_THROW(hanal::Word::tokenize(nullptr), hanal::Except);
+  EXPECT_THROW(hanal::Word::tokenize(nullptr, &chars3), hanal::Except);
 }
 
 
 TEST_F(WordTest, length) {
   const char* text1 = u8" a \t\u00E0\u00FF\u3000\uD558\uD558\uD558 \n";    // "a", "àÿ", "하하하"
-  auto words1 = hanal::Word::tokenize(text1);
+  hanal::CharBuffer chars1;
+  auto words1 = hanal::Word::tokenize(text1, &chars1);
   EXPECT_EQ(6, hanal::Word::char_len(words1));
 
   const char* text2 = "";
-  auto words2 = hanal::Word::tokenize(text2);
+  hanal::CharBuffer chars2;
+  auto words2 = hanal::Word::tokenize(text2, &chars2);
   EXPECT_EQ(0, hanal::Word::char_len(words2));
 
   const char* text3 = " \v\r";
-  auto words3 = hanal::Word::tokenize(text3);
+  hanal::CharBuffer chars3;
+  auto words3 = hanal::Word::tokenize(text3, &chars3);
   EXPECT_EQ(0, hanal::Word::char_len(words3));
 }
 
 
 TEST_F(WordTest, to_wstr) {
   const char* text1 = u8" a \t\u00E0\u00FF\u3000\uD558\uD558\uD558 \n";    // "a", "àÿ", "하하하"
-  auto words1 = hanal::Word::tokenize(text1);
-  EXPECT_STREQ(L"a", words1[0]->to_wstr().c_str());
-  EXPECT_STREQ(L"\u00E0\u00FF", words1[1]->to_wstr().c_str());    // "àÿ"
-  EXPECT_STREQ(L"\uD558\uD558\uD558", words1[2]->to_wstr().c_str());    // "하하하"
+  hanal::CharBuffer chars1;
+  auto words1 = hanal::Word::tokenize(text1, &chars1);
+  EXPECT_STREQ(L"a", words1[0].to_wstr(chars1).c_str());
+  EXPECT_STREQ(L"\u00E0\u00FF", words1[1].to_wstr(chars1).c_str());    // "àÿ"
+  EXPECT_STREQ(L"\uD558\uD558\uD558", words1[2].to_wstr(chars1).c_str());    // "하하하"
 }
 
 
 TEST_F(WordTest, to_wstr_reversed) {
   const char* text1 = u8" a \t\u00E0\u00FF\u3000\uAC00\uB098\uB2EF \n";    // "a", "àÿ", "가나다"
-  auto words1 = hanal::Word::tokenize(text1);
-  EXPECT_STREQ(L"a", words1[0]->to_wstr_reversed().c_str());
-  EXPECT_STREQ(L"\u00FF\u00E0", words1[1]->to_wstr_reversed().c_str());    // "ÿà"
-  EXPECT_STREQ(L"\uB2EF\uB098\uAC00", words1[2]->to_wstr_reversed().c_str());    // "다나가"
+  hanal::CharBuffer chars1;
+  auto words1 = hanal::Word::tokenize(text1, &chars1);
+  EXPECT_STREQ(L"a", words1[0].to_wstr_reversed(chars1).c_str());
+  EXPECT_STREQ(L"\u00FF\u00E0", words1[1].to_wstr_reversed(chars1).c_str());    // "ÿà"
+  EXPECT_STREQ(L"\uB2EF\uB098\uAC00", words1[2].to_wstr_reversed(chars1).c_str());    // "다나가"
+}
+
+
+TEST_F(WordTest, merge) {
+  const char* text1 = u8"가나 다 라";
+  hanal::CharBuffer chars1;
+  auto words1 = hanal::Word::tokenize(text1, &chars1);
+  auto merged = words1[0];
+  merged += words1[1];
+  EXPECT_EQ(0, merged.char_idx);
+  EXPECT_EQ(3, merged.size());
+  EXPECT_EQ(0, merged.begin);
+  EXPECT_EQ(10, merged.end);
+  EXPECT_STREQ(L"가나다", merged.to_wstr(chars1).c_str());
+  EXPECT_THROW(merged += words1[0], hanal::Except);    // not adjacent
 }
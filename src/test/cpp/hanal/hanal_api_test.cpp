@@ -7,6 +7,7 @@
 //////////////
 // includes //
 //////////////
+#include <cstring>
 #include <map>
 #include <string>
 
@@ -43,6 +44,30 @@ TEST(hanal_api, hanal_pos_tag) {
   const char* sent1 = u8"아버지 가방에들어 가신다.";
   const char* result1 = hanal_pos_tag(handle, sent1, "");
   std::cerr << result1 << std::endl;
+  EXPECT_NE(nullptr, strstr(result1, u8"[4] '방' (13, 16)"));    // offsets in bytes
+
+  const char* result2 = hanal_pos_tag_u16(handle, u"아버지 가방에들어 가신다.", "");
+  EXPECT_NE(nullptr, strstr(result2, u8"[4] '방' (5, 6)"));    // offsets in UTF-16 code units
+  const char* result3 = hanal_pos_tag_u32(handle, U"아버지 가방에들어 가신다.", "");
+  EXPECT_NE(nullptr, strstr(result3, u8"[4] '방' (5, 6)"));    // offsets in code points
+  EXPECT_EQ(nullptr, hanal_pos_tag_u16(handle, nullptr, ""));
+  EXPECT_EQ(nullptr, hanal_pos_tag_u16(handle, u"\xD800\uAC00", ""));    // lone surrogate (no exception escapes)
+  EXPECT_EQ(nullptr, hanal_pos_tag_u32(handle + 100, U"가방", ""));    // invalid handle
+
+  std::string doc = std::string(sent1) + u8" 아버지가 방에 들어가신다.";
+  const char* result_len = hanal_pos_tag_len(handle, doc.c_str(), strlen(sent1), "");    // first sentence only
+  EXPECT_STREQ(result1, result_len);
+  EXPECT_EQ(nullptr, hanal_pos_tag_len(handle, "\xEA\xB0", 2, ""));    // truncated UTF-8 (no exception escapes)
+  EXPECT_EQ(nullptr, hanal_pos_tag_doc_len(handle, nullptr, 0, ""));
+  const char* result_doc = hanal_pos_tag_doc_len(handle, doc.c_str() + strlen(sent1) + 1, 19, "");    // "아버지가 방에"
+  EXPECT_NE(nullptr, strstr(result_doc, "[SENT] (0, 19)"));
+
+  const char* result4 = hanal_pos_tag_doc(handle, u8"아버지 가방에들어 가신다. 아버지가 방에 들어가신다.", "");
+  EXPECT_NE(nullptr, strstr(result4, "[SENT] (0, 36) chars (0, 14)"));    // offsets in bytes and code points
+  EXPECT_NE(nullptr, strstr(result4, "[SENT] (37, 73) chars (15, 29)"));
+  EXPECT_EQ(nullptr, hanal_pos_tag_doc(handle, nullptr, ""));
+  EXPECT_NE(nullptr, strstr(result4, u8"[4] '방' (50, 53)"));    // trellis index in sentence
 
   hanal_close(handle);
+  EXPECT_EQ(nullptr, hanal_pos_tag(handle, sent1, ""));    // closed handle
 }
@@ -0,0 +1,73 @@
+#!/bin/sh
+#
+# @author     krikit(krikit@naver.com)
+# @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+#
+# build small morpheme and state-features dictionaries with both python scripts (make_syll_morph_dic.py and
+# make_state_feat_dic.py) and hanal_build_dic and compare outputs.
+# usage: build_dic_parity.sh <python2> <hanal_build_dic> <source dir>
+# exits with 77 (skipped) if python2 is not available
+
+
+set -e
+PYTHON=$1
+BUILD_DIC=$2
+SRC_DIR=$3
+
+if ! "${PYTHON}" -c 'import sys; sys.exit(sys.version_info[0] != 2)' > /dev/null 2>&1; then
+  echo "python2 is not available: ${PYTHON}"
+  exit 77
+fi
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "${WORK_DIR}"' EXIT
+
+# duplicated keys, ambiguous results, compound results, keys sharing prefixes and non-Hangul keys
+cat > "${WORK_DIR}/dic.tsv" <<'DIC'
+a	a/SL
+ac	ac/SL
+acceleration	acceleration/SL
+아버지	아버지/NNG
+가방	가방/NNG
+에	에/JKB
+들어	들/VV + 어/EC
+가	가/VV	가/JKS
+가신다	가/VV + 시/EP + ㄴ다/EF
+신다	신/VV + 다/EF
+.	./SF
+가	가/NNG
+DIC
+
+PYTHONPATH="${SRC_DIR}/main/python" "${PYTHON}" "${SRC_DIR}/main/scripts/make_syll_morph_dic.py" \
+    --input="${WORK_DIR}/dic.tsv" -o "${WORK_DIR}/py"
+"${BUILD_DIC}" --type=morph --input="${WORK_DIR}/dic.tsv" --output="${WORK_DIR}/cpp"
+
+for ext in trie val val.len val.off; do
+  cmp "${WORK_DIR}/py.${ext}" "${WORK_DIR}/cpp.${ext}"
+done
+
+# duplicated features, zero weight, weight which underflows to zero in float and invalid lines
+cat > "${WORK_DIR}/model.txt" <<'MODEL'
+LABELS = {
+}
+STATE_FEATURES = {
+  (1) 가 --> NNG: 1.500000
+  (1) 가 --> VV: -0.250000
+  (1) 가 --> JKS: 0.000000
+  (1) 가방 --> NNG: 0.000000000000000000000000000000000000000000000000001
+  (1) a --> SL: 2.000000
+  (1) 가 --> NNG: 0.750000
+  (1) 에 --> JKB
+  (1) 에 --> JKB 0.5
+  (1) 에 --> JKB: 0.125000
+}
+MODEL
+
+PYTHONPATH="${SRC_DIR}/main/python" "${PYTHON}" "${SRC_DIR}/main/scripts/make_state_feat_dic.py" \
+    --input="${WORK_DIR}/model.txt" -o "${WORK_DIR}/py_feat"
+"${BUILD_DIC}" --type=state_feat --input="${WORK_DIR}/model.txt" --output="${WORK_DIR}/cpp_feat"
+
+for ext in trie val; do
+  cmp "${WORK_DIR}/py_feat.${ext}" "${WORK_DIR}/cpp_feat.${ext}"
+done
+echo "outputs are identical"
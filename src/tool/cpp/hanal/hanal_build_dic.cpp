@@ -0,0 +1,88 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+//////////////
+// includes //
+//////////////
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>    // NOLINT
+
+#include "boost/algorithm/string/predicate.hpp"
+#include "boost/lexical_cast.hpp"
+#include "hanal/DicBuilder.hpp"
+#include "hanal/Except.hpp"
+
+
+/**
+ * build dictionary files which are the same to make_syll_morph_dic.py and make_state_feat_dic.py
+ * usage: hanal_build_dic --type={morph|state_feat} [--input=dic.tsv] --output=rsc/morph [--threads=N] [--chunk-mb=N]
+ *        [--profile=freq.tsv] [--val-format={text|binary}]
+ *        hanal_build_dic --type=morph_off --output=rsc/morph
+ * with profile of "text[<TAB>frequency]" lines, morph dictionary is laid out for cache locality (see layout_morph())
+ * and binary value format is used in place without parsing (see compile_morph_val()). morph_off type writes value
+ * offsets of morph dictionary built before them (see index_morph_val())
+ */
+int main(int argc, char** argv) {
+  std::map<std::string, std::string> args = {
+    {"threads", boost::lexical_cast<std::string>(std::max(std::thread::hardware_concurrency(), 1u))},
+    {"val-format", "text"},
+    {"chunk-mb", boost::lexical_cast<std::string>(hanal::DicBuilder::DEFAULT_CHUNK_BYTES / 1024 / 1024)},
+  };
+  for (int i = 1; i < argc; ++i) {
+    // every arguments look like '--key=value'
+    const char* delim_pos = strchr(argv[i], '=');
+    if (boost::starts_with(argv[i], "--") && delim_pos != nullptr) {
+      args[std::string(&argv[i][2], delim_pos - &argv[i][2])] = delim_pos + 1;
+    }
+  }
+  if (args.count("type") == 0 || args.count("output") == 0) {
+    std::cerr << "usage: " << argv[0] << " --type=morph|state_feat|morph_off [--input=FILE] --output=STEM [--threads=N]"
+              << " [--chunk-mb=N] [--profile=FILE] [--val-format=text|binary]" << std::endl;
+    return 1;
+  }
+
+  try {
+    std::ifstream fin;
+    if (args.count("input") > 0) {
+      fin.open(args["input"]);
+      HANAL_ASSERT(fin.good(), "Fail to open file: " + args["input"]);
+    }
+    std::istream& in = (args.count("input") > 0) ? fin : std::cin;    // stdin by default
+    int thread_num = boost::lexical_cast<int>(args["threads"]);
+    size_t chunk_bytes = boost::lexical_cast<size_t>(args["chunk-mb"]) * 1024 * 1024;
+    if (args["val-format"] != "text" && args["val-format"] != "binary") {
+      std::cerr << "unknown value format: " << args["val-format"] << std::endl;
+      return 1;
+    }
+    if (args["type"] == "morph") {
+      hanal::DicBuilder::build_morph(in, args["output"], thread_num, chunk_bytes);
+      if (args.count("profile") > 0) {
+        std::ifstream profile(args["profile"]);
+        HANAL_ASSERT(profile.good(), "Fail to open file: " + args["profile"]);
+        hanal::DicBuilder::layout_morph(args["output"], profile);
+      }
+      if (args["val-format"] == "binary") hanal::DicBuilder::compile_morph_val(args["output"]);
+    } else if (args["type"] == "morph_off") {
+      hanal::DicBuilder::index_morph_val(args["output"]);
+    } else if (args["type"] == "state_feat") {
+      hanal::DicBuilder::build_state_feat(in, args["output"], thread_num, chunk_bytes);
+    } else {
+      std::cerr << "unknown type: " << args["type"] << std::endl;
+      return 1;
+    }
+  } catch (hanal::Except& exc) {
+    std::cerr << exc.debug() << std::endl;
+    return 1;
+  } catch (boost::bad_lexical_cast& exc) {
+    std::cerr << "invalid number: " << exc.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,55 @@
+/**
+ * @author     krikit(krikit@naver.com)
+ * @copyright  Copyright (C) 2014-2015, krikit. All rights reserved. BSD 2-Clause License
+ */
+
+
+//////////////
+// includes //
+//////////////
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "boost/algorithm/string/predicate.hpp"
+#include "hanal/Except.hpp"
+#include "hanal/TrieBuilder.hpp"
+
+
+/**
+ * convert legacy trie file (written by trie.py) into other format
+ * usage: trie_conv --format={double_array|packed|dawg} --input=morph.trie --output=morph.da.trie
+ */
+int main(int argc, char** argv) {
+  std::map<std::string, std::string> args = {{"format", "double_array"}};
+  for (int i = 1; i < argc; ++i) {
+    // every arguments look like '--key=value'
+    const char* delim_pos = strchr(argv[i], '=');
+    if (boost::starts_with(argv[i], "--") && delim_pos != nullptr) {
+      args[std::string(&argv[i][2], delim_pos - &argv[i][2])] = delim_pos + 1;
+    }
+  }
+  if (args.count("input") == 0 || args.count("output") == 0) {
+    std::cerr << "usage: " << argv[0] << " [--format=double_array|packed|dawg] --input=FILE --output=FILE"
+              << std::endl;
+    return 1;
+  }
+
+  try {
+    if (args["format"] == "double_array") {
+      hanal::TrieBuilder::to_double_array(args["input"], args["output"]);
+    } else if (args["format"] == "packed") {
+      hanal::TrieBuilder::to_packed(args["input"], args["output"]);
+    } else if (args["format"] == "dawg") {
+      hanal::TrieBuilder::to_dawg(args["input"], args["output"]);
+    } else {
+      std::cerr << "unknown format: " << args["format"] << std::endl;
+      return 1;
+    }
+  } catch (hanal::Except& exc) {
+    std::cerr << exc.debug() << std::endl;
+    return 1;
+  }
+  return 0;
+}